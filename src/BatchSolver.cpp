@@ -0,0 +1,162 @@
+#include "BatchSolver.h"
+#include "CheckedArithmetic.h"
+#include <map>
+#include <utility>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+BatchSolver::BatchSolver() : vectorized_(0), fallbacks_(0) {
+    fallback_.setRecordSteps(false);
+}
+
+std::vector<int64_t> BatchSolver::solveOne(const DenseMatrix<int64_t>& system) {
+    ++fallbacks_;
+    DenseMatrix<int64_t> matrix = system;
+    try {
+        auto basis = fallback_.nullspaceBasis(matrix);
+        if (basis.size() == 1) {
+            return basis[0];
+        }
+    } catch (const std::overflow_error&) {
+    }
+    return {};
+}
+
+void BatchSolver::solveBlock(const std::vector<DenseMatrix<int64_t>>& systems, const size_t* indices, size_t count,
+                             std::vector<std::vector<int64_t>>& results) {
+    const size_t rows = systems[indices[0]].rows();
+    const size_t cols = systems[indices[0]].cols();
+    const size_t pivots = cols - 1;
+    const size_t rowStride = cols * LANES;
+
+    // Unused lanes stay zero and fail at their first pivot
+    block_.assign(rows * rowStride, 0.0);
+    bool usable[LANES] = {};
+    for (size_t lane = 0; lane < count; ++lane) {
+        const DenseMatrix<int64_t>& system = systems[indices[lane]];
+        usable[lane] = true;
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < cols; ++j) {
+                int64_t value = system[i][j];
+                usable[lane] = usable[lane] && std::abs(static_cast<double>(value)) < EXACT_LIMIT;
+                block_[i * rowStride + j * LANES + lane] = static_cast<double>(value);
+            }
+        }
+    }
+
+    // Fraction-free Gauss-Jordan: every row but the pivot row is updated at
+    // each step, dividing by the previous pivot, so all entries stay minors
+    // of the input and the pivot block ends as det * I
+    alignas(64) double pivot[LANES];
+    alignas(64) double factor[LANES];
+    alignas(64) double previous[LANES];
+    alignas(64) double magnitude[LANES];
+    for (size_t lane = 0; lane < LANES; ++lane) {
+        previous[lane] = 1.0;
+        magnitude[lane] = 0.0;
+    }
+
+    for (size_t k = 0; k < pivots; ++k) {
+        double* pivotRow = &block_[k * rowStride];
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            // Rows from k down have seen identical updates, so swapping two
+            // of them in one lane is the same as permuting that input
+            if (usable[lane] && pivotRow[k * LANES + lane] == 0.0) {
+                size_t swapRow = k + 1;
+                while (swapRow < rows && block_[swapRow * rowStride + k * LANES + lane] == 0.0) {
+                    ++swapRow;
+                }
+                if (swapRow < rows) {
+                    double* other = &block_[swapRow * rowStride];
+                    for (size_t j = 0; j < cols; ++j) {
+                        std::swap(pivotRow[j * LANES + lane], other[j * LANES + lane]);
+                    }
+                }
+            }
+            pivot[lane] = pivotRow[k * LANES + lane];
+            usable[lane] = usable[lane] && pivot[lane] != 0.0;
+        }
+
+        for (size_t i = 0; i < rows; ++i) {
+            if (i == k) {
+                continue;
+            }
+            double* row = &block_[i * rowStride];
+            for (size_t lane = 0; lane < LANES; ++lane) {
+                factor[lane] = row[k * LANES + lane];
+            }
+            RowKernels::fractionFreeLanes(row, pivotRow, pivot, factor, previous, magnitude, cols);
+        }
+
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            previous[lane] = pivot[lane];
+        }
+    }
+
+    for (size_t lane = 0; lane < count; ++lane) {
+        size_t index = indices[lane];
+        if (!usable[lane] || !(magnitude[lane] < EXACT_LIMIT)) {
+            results[index] = solveOne(systems[index]);
+            continue;
+        }
+        ++vectorized_;
+
+        // The leading columns are independent, so any entry left in the
+        // rows below them means full column rank and no null vector
+        bool fullRank = false;
+        for (size_t i = pivots; i < rows; ++i) {
+            fullRank = fullRank || block_[i * rowStride + pivots * LANES + lane] != 0.0;
+        }
+        if (fullRank) {
+            results[index].clear();
+            continue;
+        }
+
+        // Row k reads det * x_k + a_k * x_last = 0
+        int64_t determinant = static_cast<int64_t>(previous[lane]);
+        std::vector<int64_t> vector(cols);
+        vector[pivots] = determinant;
+        for (size_t k = 0; k < pivots; ++k) {
+            vector[k] = -static_cast<int64_t>(block_[k * rowStride + pivots * LANES + lane]);
+        }
+
+        int64_t divisor = 0;
+        for (int64_t value : vector) {
+            divisor = gcd64(divisor, value);
+        }
+        if (determinant < 0) {
+            divisor = -divisor;
+        }
+        for (int64_t& value : vector) {
+            value /= divisor;
+        }
+        results[index] = std::move(vector);
+    }
+}
+
+std::vector<std::vector<int64_t>> BatchSolver::nullVectors(const std::vector<DenseMatrix<int64_t>>& systems) {
+    vectorized_ = 0;
+    fallbacks_ = 0;
+    std::vector<std::vector<int64_t>> results(systems.size());
+
+    // Only shapes with enough rows for a dimension-1 nullspace go to the lanes
+    std::map<std::pair<size_t, size_t>, std::vector<size_t>> shapes;
+    for (size_t index = 0; index < systems.size(); ++index) {
+        const DenseMatrix<int64_t>& system = systems[index];
+        if (system.cols() < 2 || system.rows() + 1 < system.cols()) {
+            results[index] = solveOne(system);
+        } else {
+            shapes[{system.rows(), system.cols()}].push_back(index);
+        }
+    }
+
+    for (const auto& shape : shapes) {
+        const std::vector<size_t>& indices = shape.second;
+        for (size_t start = 0; start < indices.size(); start += LANES) {
+            solveBlock(systems, indices.data() + start, std::min(LANES, indices.size() - start), results);
+        }
+    }
+
+    return results;
+}
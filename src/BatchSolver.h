@@ -0,0 +1,52 @@
+#ifndef BATCH_SOLVER_H
+#define BATCH_SOLVER_H
+
+#include "DenseMatrix.h"
+#include "MatrixSolver.h"
+#include "RowKernels.h"
+#include <vector>
+#include <cstdint>
+
+// Exact null vectors of many small systems at once. Systems of the same
+// shape are interleaved RowKernels::LANES at a time, entry by entry, and
+// reduced together by fraction-free Gauss-Jordan elimination in double,
+// one system per SIMD lane.
+//
+// Columns are taken in order, as MatrixSolver does; a lane with a zero
+// pivot swaps in a later row of its own. Doubles hold the integer minors
+// exactly only while every product stays below EXACT_LIMIT. A lane whose
+// column has no pivot at all, or that meets a larger product, is masked
+// out of the result and solved on its own by MatrixSolver, so every answer
+// is exact.
+class BatchSolver {
+public:
+    static constexpr size_t LANES = RowKernels::LANES;
+    // 2^52: products below this, and their differences, are exact in double
+    static constexpr double EXACT_LIMIT = 4503599627370496.0;
+
+private:
+    MatrixSolver fallback_;
+    std::vector<double> block_; // rows x cols x LANES, reused between blocks
+    size_t vectorized_;
+    size_t fallbacks_;
+
+    std::vector<int64_t> solveOne(const DenseMatrix<int64_t>& system);
+    // Systems indices[0..count) share one shape and count <= LANES
+    void solveBlock(const std::vector<DenseMatrix<int64_t>>& systems, const size_t* indices, size_t count,
+                    std::vector<std::vector<int64_t>>& results);
+
+public:
+    BatchSolver();
+
+    // For each system the vector MatrixSolver::nullspaceBasis returns when
+    // the nullspace has dimension 1: primitive, with its free entry
+    // positive. Empty when the dimension is not 1, or when neither the
+    // lanes nor MatrixSolver can compute it in 64 bits.
+    std::vector<std::vector<int64_t>> nullVectors(const std::vector<DenseMatrix<int64_t>>& systems);
+
+    // Systems of the last call solved in SIMD lanes, and on their own
+    size_t vectorizedCount() const { return vectorized_; }
+    size_t fallbackCount() const { return fallbacks_; }
+};
+
+#endif // BATCH_SOLVER_H
@@ -0,0 +1,342 @@
+#include "BigInteger.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+BigInteger::BigInteger(int64_t value) : negative_(value < 0) {
+    uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    while (magnitude != 0) {
+        limbs_.push_back(static_cast<uint32_t>(magnitude));
+        magnitude >>= 32;
+    }
+}
+
+void BigInteger::trim() {
+    while (!limbs_.empty() && limbs_.back() == 0) {
+        limbs_.pop_back();
+    }
+    if (limbs_.empty()) {
+        negative_ = false;
+    }
+}
+
+size_t BigInteger::bitLength() const {
+    if (limbs_.empty()) {
+        return 0;
+    }
+    size_t bits = 32 * (limbs_.size() - 1);
+    for (uint32_t top = limbs_.back(); top != 0; top >>= 1) {
+        ++bits;
+    }
+    return bits;
+}
+
+bool BigInteger::fitsInt64() const {
+    if (limbs_.size() <= 1) {
+        return true;
+    }
+    if (limbs_.size() > 2) {
+        return false;
+    }
+    uint64_t magnitude = (static_cast<uint64_t>(limbs_[1]) << 32) | limbs_[0];
+    uint64_t limit = static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+    return magnitude <= limit || (negative_ && magnitude == limit + 1);
+}
+
+int64_t BigInteger::toInt64() const {
+    if (!fitsInt64()) {
+        throw std::overflow_error("Integer does not fit in 64 bits");
+    }
+    uint64_t magnitude = 0;
+    for (size_t i = limbs_.size(); i-- > 0;) {
+        magnitude = (magnitude << 32) | limbs_[i];
+    }
+    return negative_ ? static_cast<int64_t>(0 - magnitude) : static_cast<int64_t>(magnitude);
+}
+
+std::string BigInteger::toString() const {
+    if (limbs_.empty()) {
+        return "0";
+    }
+
+    // Peel off nine decimal digits per single-limb division
+    std::vector<uint32_t> magnitude = limbs_;
+    std::vector<uint32_t> chunks;
+    while (!magnitude.empty()) {
+        uint64_t remainder = 0;
+        for (size_t i = magnitude.size(); i-- > 0;) {
+            uint64_t current = (remainder << 32) | magnitude[i];
+            magnitude[i] = static_cast<uint32_t>(current / 1000000000u);
+            remainder = current % 1000000000u;
+        }
+        while (!magnitude.empty() && magnitude.back() == 0) {
+            magnitude.pop_back();
+        }
+        chunks.push_back(static_cast<uint32_t>(remainder));
+    }
+
+    std::string result = negative_ ? "-" : "";
+    result += std::to_string(chunks.back());
+    for (size_t i = chunks.size() - 1; i-- > 0;) {
+        std::string chunk = std::to_string(chunks[i]);
+        result += std::string(9 - chunk.size(), '0') + chunk;
+    }
+    return result;
+}
+
+BigInteger BigInteger::operator-() const {
+    BigInteger result = *this;
+    if (!result.limbs_.empty()) {
+        result.negative_ = !result.negative_;
+    }
+    return result;
+}
+
+BigInteger BigInteger::abs() const {
+    BigInteger result = *this;
+    result.negative_ = false;
+    return result;
+}
+
+int BigInteger::compareMagnitude(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+    if (a.size() != b.size()) {
+        return a.size() < b.size() ? -1 : 1;
+    }
+    for (size_t i = a.size(); i-- > 0;) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+int BigInteger::compare(const BigInteger& other) const {
+    if (negative_ != other.negative_) {
+        return negative_ ? -1 : 1;
+    }
+    int magnitude = compareMagnitude(limbs_, other.limbs_);
+    return negative_ ? -magnitude : magnitude;
+}
+
+void BigInteger::addMagnitude(std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+    if (a.size() < b.size()) {
+        a.resize(b.size(), 0);
+    }
+    uint64_t carry = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        uint64_t sum = static_cast<uint64_t>(a[i]) + (i < b.size() ? b[i] : 0) + carry;
+        a[i] = static_cast<uint32_t>(sum);
+        carry = sum >> 32;
+        if (carry == 0 && i >= b.size()) {
+            break;
+        }
+    }
+    if (carry != 0) {
+        a.push_back(static_cast<uint32_t>(carry));
+    }
+}
+
+void BigInteger::subtractMagnitude(std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+    int64_t borrow = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        int64_t difference = static_cast<int64_t>(a[i]) - (i < b.size() ? b[i] : 0) - borrow;
+        a[i] = static_cast<uint32_t>(difference);
+        borrow = difference < 0 ? 1 : 0;
+        if (borrow == 0 && i >= b.size()) {
+            break;
+        }
+    }
+}
+
+void BigInteger::addSigned(const BigInteger& other, bool negateOther) {
+    bool otherNegative = negateOther ? !other.negative_ : other.negative_;
+    if (other.limbs_.empty()) {
+        return;
+    }
+    if (negative_ == otherNegative || limbs_.empty()) {
+        addMagnitude(limbs_, other.limbs_);
+        negative_ = otherNegative;
+    } else if (compareMagnitude(limbs_, other.limbs_) >= 0) {
+        subtractMagnitude(limbs_, other.limbs_);
+    } else {
+        std::vector<uint32_t> magnitude = other.limbs_;
+        subtractMagnitude(magnitude, limbs_);
+        limbs_.swap(magnitude);
+        negative_ = otherNegative;
+    }
+    trim();
+}
+
+BigInteger& BigInteger::operator+=(const BigInteger& other) {
+    addSigned(other, false);
+    return *this;
+}
+
+BigInteger& BigInteger::operator-=(const BigInteger& other) {
+    addSigned(other, true);
+    return *this;
+}
+
+BigInteger& BigInteger::operator*=(const BigInteger& other) {
+    if (limbs_.empty() || other.limbs_.empty()) {
+        *this = BigInteger();
+        return *this;
+    }
+
+    std::vector<uint32_t> product(limbs_.size() + other.limbs_.size(), 0);
+    for (size_t i = 0; i < limbs_.size(); ++i) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < other.limbs_.size(); ++j) {
+            uint64_t current = static_cast<uint64_t>(limbs_[i]) * other.limbs_[j] + product[i + j] + carry;
+            product[i + j] = static_cast<uint32_t>(current);
+            carry = current >> 32;
+        }
+        product[i + other.limbs_.size()] = static_cast<uint32_t>(carry);
+    }
+
+    limbs_.swap(product);
+    negative_ = negative_ != other.negative_;
+    trim();
+    return *this;
+}
+
+// Long division in base 2^32 (Knuth, TAOCP vol. 2, algorithm D): the divisor
+// is normalised so its top bit is set, which keeps each estimated quotient
+// digit at most two above the true one
+void BigInteger::divideMagnitude(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b,
+                                 std::vector<uint32_t>& quotient, std::vector<uint32_t>& remainder) {
+    if (compareMagnitude(a, b) < 0) {
+        quotient.clear();
+        remainder = a;
+        return;
+    }
+
+    size_t n = b.size();
+    size_t m = a.size();
+    quotient.assign(m - n + 1, 0);
+
+    if (n == 1) {
+        uint64_t rest = 0;
+        for (size_t i = m; i-- > 0;) {
+            uint64_t current = (rest << 32) | a[i];
+            quotient[i] = static_cast<uint32_t>(current / b[0]);
+            rest = current % b[0];
+        }
+        remainder.assign(1, static_cast<uint32_t>(rest));
+    } else {
+        int shift = 0;
+        for (uint32_t top = b[n - 1]; !(top & 0x80000000u); top <<= 1) {
+            ++shift;
+        }
+
+        std::vector<uint32_t> divisor(n);
+        for (size_t i = n - 1; i > 0; --i) {
+            divisor[i] = static_cast<uint32_t>((static_cast<uint64_t>(b[i]) << shift) | (static_cast<uint64_t>(b[i - 1]) >> (32 - shift)));
+        }
+        divisor[0] = static_cast<uint32_t>(static_cast<uint64_t>(b[0]) << shift);
+
+        std::vector<uint32_t> dividend(m + 1);
+        dividend[m] = static_cast<uint32_t>(static_cast<uint64_t>(a[m - 1]) >> (32 - shift));
+        for (size_t i = m - 1; i > 0; --i) {
+            dividend[i] = static_cast<uint32_t>((static_cast<uint64_t>(a[i]) << shift) | (static_cast<uint64_t>(a[i - 1]) >> (32 - shift)));
+        }
+        dividend[0] = static_cast<uint32_t>(static_cast<uint64_t>(a[0]) << shift);
+
+        const uint64_t base = uint64_t(1) << 32;
+        for (size_t j = m - n + 1; j-- > 0;) {
+            uint64_t numerator = (static_cast<uint64_t>(dividend[j + n]) << 32) | dividend[j + n - 1];
+            uint64_t estimate = numerator / divisor[n - 1];
+            uint64_t rest = numerator % divisor[n - 1];
+            while (estimate >= base || estimate * divisor[n - 2] > ((rest << 32) | dividend[j + n - 2])) {
+                --estimate;
+                rest += divisor[n - 1];
+                if (rest >= base) {
+                    break;
+                }
+            }
+
+            int64_t borrow = 0;
+            uint64_t carry = 0;
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t product = estimate * divisor[i] + carry;
+                carry = product >> 32;
+                int64_t difference = static_cast<int64_t>(dividend[i + j]) - borrow - static_cast<int64_t>(product & 0xFFFFFFFFu);
+                dividend[i + j] = static_cast<uint32_t>(difference);
+                borrow = difference < 0 ? 1 : 0;
+            }
+            int64_t top = static_cast<int64_t>(dividend[j + n]) - borrow - static_cast<int64_t>(carry);
+            dividend[j + n] = static_cast<uint32_t>(top);
+
+            // The estimate was one too large: add the divisor back
+            if (top < 0) {
+                --estimate;
+                uint64_t sum = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    sum = static_cast<uint64_t>(dividend[i + j]) + divisor[i] + (sum >> 32);
+                    dividend[i + j] = static_cast<uint32_t>(sum);
+                }
+                dividend[j + n] += static_cast<uint32_t>(sum >> 32);
+            }
+            quotient[j] = static_cast<uint32_t>(estimate);
+        }
+
+        remainder.assign(n, 0);
+        for (size_t i = 0; i < n; ++i) {
+            remainder[i] = static_cast<uint32_t>((static_cast<uint64_t>(dividend[i]) >> shift) |
+                                                 (static_cast<uint64_t>(dividend[i + 1]) << (32 - shift)));
+        }
+    }
+
+    while (!quotient.empty() && quotient.back() == 0) {
+        quotient.pop_back();
+    }
+    while (!remainder.empty() && remainder.back() == 0) {
+        remainder.pop_back();
+    }
+}
+
+void BigInteger::divide(const BigInteger& a, const BigInteger& b, BigInteger& quotient, BigInteger& remainder) {
+    if (b.limbs_.empty()) {
+        throw std::domain_error("Division by zero");
+    }
+    bool quotientNegative = a.negative_ != b.negative_;
+    bool remainderNegative = a.negative_;
+    divideMagnitude(a.limbs_, b.limbs_, quotient.limbs_, remainder.limbs_);
+    quotient.negative_ = quotientNegative;
+    remainder.negative_ = remainderNegative;
+    quotient.trim();
+    remainder.trim();
+}
+
+BigInteger& BigInteger::operator/=(const BigInteger& other) {
+    BigInteger quotient;
+    BigInteger remainder;
+    divide(*this, other, quotient, remainder);
+    return *this = quotient;
+}
+
+BigInteger& BigInteger::operator%=(const BigInteger& other) {
+    BigInteger quotient;
+    BigInteger remainder;
+    divide(*this, other, quotient, remainder);
+    return *this = remainder;
+}
+
+uint64_t BigInteger::mod(uint64_t modulus) const {
+    unsigned __int128 rest = 0;
+    for (size_t i = limbs_.size(); i-- > 0;) {
+        rest = ((rest << 32) | limbs_[i]) % modulus;
+    }
+    uint64_t result = static_cast<uint64_t>(rest);
+    return negative_ && result != 0 ? modulus - result : result;
+}
+
+BigInteger BigInteger::gcd(BigInteger a, BigInteger b) {
+    a.negative_ = false;
+    b.negative_ = false;
+    while (!b.isZero()) {
+        a %= b;
+        std::swap(a, b);
+    }
+    return a;
+}
@@ -0,0 +1,73 @@
+#ifndef BIG_INTEGER_H
+#define BIG_INTEGER_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Arbitrary-precision signed integer for results that outgrow 64 bits.
+// Sign and magnitude, the magnitude in base 2^32 limbs, least significant
+// first. Division truncates towards zero and the remainder takes the sign
+// of the dividend, as with built-in integers.
+class BigInteger {
+private:
+    std::vector<uint32_t> limbs_; // no leading zero limbs; empty for zero
+    bool negative_;
+
+    void trim();
+    static int compareMagnitude(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
+    static void addMagnitude(std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
+    // a -= b, requires |a| >= |b|
+    static void subtractMagnitude(std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
+    static void divideMagnitude(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b,
+                                std::vector<uint32_t>& quotient, std::vector<uint32_t>& remainder);
+    void addSigned(const BigInteger& other, bool negateOther);
+
+public:
+    BigInteger() : negative_(false) {}
+    BigInteger(int64_t value);
+
+    bool isZero() const { return limbs_.empty(); }
+    bool isNegative() const { return negative_; }
+    int sign() const { return negative_ ? -1 : (limbs_.empty() ? 0 : 1); }
+    size_t bitLength() const;
+
+    bool fitsInt64() const;
+    // Throws std::overflow_error when the value does not fit
+    int64_t toInt64() const;
+    std::string toString() const;
+
+    BigInteger operator-() const;
+    BigInteger abs() const;
+
+    BigInteger& operator+=(const BigInteger& other);
+    BigInteger& operator-=(const BigInteger& other);
+    BigInteger& operator*=(const BigInteger& other);
+    // Throw std::domain_error on division by zero
+    BigInteger& operator/=(const BigInteger& other);
+    BigInteger& operator%=(const BigInteger& other);
+
+    // Remainder in [0, modulus) for a non-zero modulus, whatever the sign
+    uint64_t mod(uint64_t modulus) const;
+
+    int compare(const BigInteger& other) const;
+
+    static BigInteger gcd(BigInteger a, BigInteger b);
+    // Quotient and remainder in one division
+    static void divide(const BigInteger& a, const BigInteger& b, BigInteger& quotient, BigInteger& remainder);
+};
+
+inline BigInteger operator+(BigInteger a, const BigInteger& b) { return a += b; }
+inline BigInteger operator-(BigInteger a, const BigInteger& b) { return a -= b; }
+inline BigInteger operator*(BigInteger a, const BigInteger& b) { return a *= b; }
+inline BigInteger operator/(BigInteger a, const BigInteger& b) { return a /= b; }
+inline BigInteger operator%(BigInteger a, const BigInteger& b) { return a %= b; }
+
+inline bool operator==(const BigInteger& a, const BigInteger& b) { return a.compare(b) == 0; }
+inline bool operator!=(const BigInteger& a, const BigInteger& b) { return a.compare(b) != 0; }
+inline bool operator<(const BigInteger& a, const BigInteger& b) { return a.compare(b) < 0; }
+inline bool operator<=(const BigInteger& a, const BigInteger& b) { return a.compare(b) <= 0; }
+inline bool operator>(const BigInteger& a, const BigInteger& b) { return a.compare(b) > 0; }
+inline bool operator>=(const BigInteger& a, const BigInteger& b) { return a.compare(b) >= 0; }
+
+#endif // BIG_INTEGER_H
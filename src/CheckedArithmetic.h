@@ -0,0 +1,123 @@
+#ifndef CHECKED_ARITHMETIC_H
+#define CHECKED_ARITHMETIC_H
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+// Integer helpers for the exact solvers and coefficient arithmetic. Every
+// overflow throws std::overflow_error, which callers treat as "retry with
+// more precision" or "fall back to floating point".
+//
+// GCC and Clang check with the overflow flag of the operation itself; the
+// portable versions compare against the limits first.
+
+[[noreturn]] inline void throwIntegerOverflow() {
+    throw std::overflow_error("Integer overflow in exact arithmetic");
+}
+
+inline int64_t checkedMultiply(int64_t a, int64_t b) {
+#if defined(__GNUC__)
+    int64_t result;
+    if (__builtin_mul_overflow(a, b, &result)) {
+        throwIntegerOverflow();
+    }
+    return result;
+#else
+    uint64_t magnitudeA = a < 0 ? 0 - static_cast<uint64_t>(a) : static_cast<uint64_t>(a);
+    uint64_t magnitudeB = b < 0 ? 0 - static_cast<uint64_t>(b) : static_cast<uint64_t>(b);
+    bool negative = (a < 0) != (b < 0);
+    uint64_t limit = static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + (negative ? 1 : 0);
+    if (magnitudeA != 0 && magnitudeB > limit / magnitudeA) {
+        throwIntegerOverflow();
+    }
+    return a * b;
+#endif
+}
+
+inline int64_t checkedAdd(int64_t a, int64_t b) {
+#if defined(__GNUC__)
+    int64_t result;
+    if (__builtin_add_overflow(a, b, &result)) {
+        throwIntegerOverflow();
+    }
+    return result;
+#else
+    if ((b > 0 && a > std::numeric_limits<int64_t>::max() - b) ||
+        (b < 0 && a < std::numeric_limits<int64_t>::min() - b)) {
+        throwIntegerOverflow();
+    }
+    return a + b;
+#endif
+}
+
+inline int64_t checkedSubtract(int64_t a, int64_t b) {
+#if defined(__GNUC__)
+    int64_t result;
+    if (__builtin_sub_overflow(a, b, &result)) {
+        throwIntegerOverflow();
+    }
+    return result;
+#else
+    if ((b > 0 && a < std::numeric_limits<int64_t>::min() + b) ||
+        (b < 0 && a > std::numeric_limits<int64_t>::max() + b)) {
+        throwIntegerOverflow();
+    }
+    return a - b;
+#endif
+}
+
+// Non-negative gcd of the magnitudes, computed unsigned so that INT64_MIN
+// is allowed; throws only for gcd(INT64_MIN, INT64_MIN or 0), which is 2^63
+inline int64_t gcd64(int64_t a, int64_t b) {
+    uint64_t x = a < 0 ? 0 - static_cast<uint64_t>(a) : static_cast<uint64_t>(a);
+    uint64_t y = b < 0 ? 0 - static_cast<uint64_t>(b) : static_cast<uint64_t>(b);
+    while (y != 0) {
+        uint64_t temp = y;
+        y = x % y;
+        x = temp;
+    }
+    if (x > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+        throwIntegerOverflow();
+    }
+    return static_cast<int64_t>(x);
+}
+
+// Least common multiple of the magnitudes, 0 if either is 0
+inline int64_t checkedLcm(int64_t a, int64_t b) {
+    if (a == 0 || b == 0) {
+        return 0;
+    }
+    int64_t product = checkedMultiply(a / gcd64(a, b), b);
+    return product < 0 ? checkedSubtract(0, product) : product;
+}
+
+// 128-bit intermediates, where the compiler has them. They let a chain of
+// 64-bit values be combined without checking every step; only the final
+// narrowing has to be checked.
+#if defined(__SIZEOF_INT128__)
+#define CHECKED_ARITHMETIC_INT128 1
+
+using int128 = __int128;
+
+inline bool multiplyOverflows128(int128 a, int128 b, int128& result) {
+    return __builtin_mul_overflow(a, b, &result);
+}
+
+inline int128 gcd128(int128 a, int128 b) {
+    a = a < 0 ? -a : a;
+    b = b < 0 ? -b : b;
+    while (b != 0) {
+        int128 temp = b;
+        b = a % b;
+        a = temp;
+    }
+    return a;
+}
+
+inline bool fitsInt64(int128 value) {
+    return value >= std::numeric_limits<int64_t>::min() && value <= std::numeric_limits<int64_t>::max();
+}
+#endif
+
+#endif // CHECKED_ARITHMETIC_H
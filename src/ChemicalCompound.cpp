@@ -1,125 +1,260 @@
 #include "ChemicalCompound.h"
 #include "CompoundDatabase.h"
-#include <regex>
-#include <iostream>
+#include "EquationTokenizer.h"
+#include "FormulaScanner.h"
+#include "FormulaLiteral.h"
+#include "CheckedArithmetic.h"
 #include <sstream>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
 
-ChemicalCompound::ChemicalCompound(const std::string& formula) 
-    : molarMass_(0.0), formula_(formula), valid_(false) {
-    try {
-        parseFormula(formula);
-        calculateMolarMass();
-        valid_ = true;
-    } catch (const std::exception& e) {
-        std::cerr << "Error parsing formula " << formula << ": " << e.what() << std::endl;
-        valid_ = false;
+ElementCounts::ElementCounts() : inline_(), size_(0) {}
+
+int64_t& ElementCounts::operator[](uint8_t atomicNumber) {
+    ElementEntry* entries = data();
+    size_t pos = 0;
+    while (pos < size_ && entries[pos].atomicNumber < atomicNumber) {
+        ++pos;
+    }
+    if (pos < size_ && entries[pos].atomicNumber == atomicNumber) {
+        return entries[pos].count;
     }
+    
+    if (!spill_.empty()) {
+        spill_.insert(spill_.begin() + pos, {atomicNumber, 0});
+    } else if (size_ < INLINE_CAPACITY) {
+        for (size_t i = size_; i > pos; --i) {
+            inline_[i] = inline_[i - 1];
+        }
+        inline_[pos] = {atomicNumber, 0};
+    } else {
+        spill_.assign(inline_.begin(), inline_.end());
+        spill_.insert(spill_.begin() + pos, {atomicNumber, 0});
+    }
+    ++size_;
+    
+    return data()[pos].count;
 }
 
-std::string ChemicalCompound::parseFormula(const std::string& formula) {
-    elements_.clear();
+int64_t ElementCounts::count(uint8_t atomicNumber) const {
+    for (const ElementEntry& entry : *this) {
+        if (entry.atomicNumber == atomicNumber) {
+            return entry.count;
+        }
+        if (entry.atomicNumber > atomicNumber) {
+            break;
+        }
+    }
+    return 0;
+}
+
+void ElementCounts::clear() {
+    spill_.clear();
+    size_ = 0;
+}
+
+ChemicalCompound::ChemicalCompound(std::string_view formula) {
+    auto data = std::make_shared<Data>();
+    data->formula = formula;
+    data->diagnostic = parseFormula(formula, data->elements);
     
-    // Clean the formula (remove spaces and states like (s), (l), (g), (aq))
-    std::string cleanFormula = formula;
-    std::regex stateRegex(R"(\s*\([slgaq]\)\s*)");
-    cleanFormula = std::regex_replace(cleanFormula, stateRegex, "");
+    if (data->diagnostic.ok()) {
+        data->molarMass = calculateMolarMass(data->elements);
+    } else {
+        data->elements.clear();
+    }
     
-    // Remove extra spaces
-    std::regex spaceRegex(R"(\s+)");
-    cleanFormula = std::regex_replace(cleanFormula, spaceRegex, "");
+    data_ = std::move(data);
+}
+
+ChemicalCompound::ChemicalCompound(const FormulaLiteral& literal) {
+    auto data = std::make_shared<Data>();
+    data->formula = literal.formula();
+    data->diagnostic = literal.diagnostic();
+    data->molarMass = literal.molarMass();
     
-    // Parse the formula recursively
-    parseGroup(cleanFormula, 0, cleanFormula.length(), 1);
+    for (int atomicNumber = 1; atomicNumber <= CompoundDatabase::MAX_ATOMIC_NUMBER; ++atomicNumber) {
+        if (literal.contains(atomicNumber)) {
+            data->elements[static_cast<uint8_t>(atomicNumber)] = literal.count(atomicNumber);
+        }
+    }
     
-    return cleanFormula;
+    data_ = std::move(data);
+}
+
+// Element counts are never negative, which keeps the overflow checks simple
+static bool multiplyCount(int64_t a, int64_t b, int64_t& result) {
+    if (a != 0 && b > std::numeric_limits<int64_t>::max() / a) {
+        return false;
+    }
+    result = a * b;
+    return true;
+}
+
+static bool addCount(int64_t a, int64_t b, int64_t& result) {
+    if (a > std::numeric_limits<int64_t>::max() - b) {
+        return false;
+    }
+    result = a + b;
+    return true;
 }
 
-void ChemicalCompound::parseGroup(const std::string& formula, size_t start, size_t end, int multiplier) {
-    size_t i = start;
+ParseDiagnostic ChemicalCompound::parseFormula(std::string_view formula, ElementCounts& elements) {
+    elements.clear();
+    
+    // Single right-to-left pass: a number always follows the element or group
+    // it multiplies, so scanning backwards sees every multiplier before its
+    // target. The stack holds the accumulated multiplier of each open group,
+    // which keeps the parse linear and free of recursion for any nesting depth.
+    // Whitespace and state suffixes like (s), (l), (g), (aq) are skipped in
+    // place so that error positions refer to the original text.
+    struct GroupFrame {
+        int64_t multiplier;
+        size_t position; // of the closing parenthesis
+    };
+    
+    CompoundDatabase& db = CompoundDatabase::getInstance();
+    std::vector<GroupFrame> groups = {{1, 0}};
+    int64_t pending = 1;
+    size_t pendingPosition = 0;
+    bool hasPending = false;
     
-    while (i < end) {
-        if (std::isupper(formula[i])) {
-            // Element symbol
-            std::string element;
-            element += formula[i++];
+    size_t i = formula.length();
+    while (i > 0) {
+        char c = formula[i - 1];
+        uint8_t charClass = FormulaScanner::classOf(c);
+        
+        if (charClass == CHAR_SPACE) {
+            --i;
             
-            // Check for lowercase letter (part of element symbol)
-            while (i < end && std::islower(formula[i])) {
-                element += formula[i++];
+        } else if (charClass == CHAR_DIGIT) {
+            size_t digitsEnd = i;
+            while (i > 0 && FormulaScanner::classOf(formula[i - 1]) == CHAR_DIGIT) {
+                --i;
             }
             
-            // Get number following element
-            int count = 1;
-            if (i < end && std::isdigit(formula[i])) {
-                count = 0;
-                while (i < end && std::isdigit(formula[i])) {
-                    count = count * 10 + (formula[i++] - '0');
+            pending = 0;
+            for (size_t d = i; d < digitsEnd; ++d) {
+                if (!multiplyCount(pending, 10, pending) || !addCount(pending, formula[d] - '0', pending)) {
+                    return {ParseStatus::COUNT_OVERFLOW, i, "Count too large"};
                 }
             }
+            pendingPosition = i;
+            hasPending = true;
             
-            // Add to elements map
-            elements_[element] += count * multiplier;
+        } else if (charClass == CHAR_CLOSE) {
+            if (size_t stateLength = EquationTokenizer::stateLengthBefore(formula, i)) {
+                i -= stateLength;
+                continue;
+            }
             
-        } else if (formula[i] == '(') {
-            // Find matching closing parenthesis
-            int depth = 1;
-            size_t groupStart = i + 1;
-            i++;
+            int64_t groupMultiplier;
+            if (!multiplyCount(groups.back().multiplier, pending, groupMultiplier)) {
+                return {ParseStatus::COUNT_OVERFLOW, i - 1, "Group multiplier overflow"};
+            }
+            groups.push_back({groupMultiplier, i - 1});
+            pending = 1;
+            hasPending = false;
+            --i;
             
-            while (i < end && depth > 0) {
-                if (formula[i] == '(') depth++;
-                else if (formula[i] == ')') depth--;
-                i++;
+        } else if (charClass == CHAR_OPEN) {
+            if (hasPending) {
+                return {ParseStatus::INVALID_CHARACTER, pendingPosition, "Number not attached to an element or group"};
+            }
+            if (groups.size() == 1) {
+                return {ParseStatus::UNMATCHED_PARENTHESIS, i - 1, "Unmatched '('"};
             }
+            groups.pop_back();
+            --i;
             
-            size_t groupEnd = i - 1;
+        } else if (charClass & (CHAR_UPPER | CHAR_LOWER)) {
+            // Element symbol: one uppercase letter followed by lowercase letters
+            size_t symbolEnd = i;
+            while (i > 0 && FormulaScanner::classOf(formula[i - 1]) == CHAR_LOWER) {
+                --i;
+            }
+            if (i == 0 || FormulaScanner::classOf(formula[i - 1]) != CHAR_UPPER) {
+                return {ParseStatus::INVALID_CHARACTER, i, "Element symbol must start with an uppercase letter"};
+            }
+            --i;
             
-            // Get multiplier after closing parenthesis
-            int groupMultiplier = 1;
-            if (i < end && std::isdigit(formula[i])) {
-                groupMultiplier = 0;
-                while (i < end && std::isdigit(formula[i])) {
-                    groupMultiplier = groupMultiplier * 10 + (formula[i++] - '0');
-                }
+            int atomicNumber = db.getAtomicNumber(formula.substr(i, symbolEnd - i));
+            if (atomicNumber == 0) {
+                return {ParseStatus::UNKNOWN_ELEMENT, i, "Unknown element"};
             }
             
-            // Parse the group recursively
-            parseGroup(formula, groupStart, groupEnd, multiplier * groupMultiplier);
+            int64_t& total = elements[static_cast<uint8_t>(atomicNumber)];
+            int64_t count;
+            if (!multiplyCount(groups.back().multiplier, pending, count) || !addCount(total, count, total)) {
+                return {ParseStatus::COUNT_OVERFLOW, i, "Element count overflow"};
+            }
+            pending = 1;
+            hasPending = false;
             
         } else {
-            throw std::invalid_argument("Invalid character in formula: " + std::string(1, formula[i]));
+            return {ParseStatus::INVALID_CHARACTER, i - 1, "Invalid character"};
         }
     }
+    
+    if (hasPending) {
+        return {ParseStatus::INVALID_CHARACTER, pendingPosition, "Number not attached to an element or group"};
+    }
+    if (groups.size() != 1) {
+        return {ParseStatus::UNMATCHED_PARENTHESIS, groups[1].position, "Unmatched ')'"};
+    }
+    if (elements.empty()) {
+        return {ParseStatus::EMPTY_FORMULA, 0, "Formula has no elements"};
+    }
+    
+    return ParseDiagnostic::success();
 }
 
-void ChemicalCompound::calculateMolarMass() {
-    molarMass_ = 0.0;
+double ChemicalCompound::calculateMolarMass(const ElementCounts& elements) {
+    double molarMass = 0.0;
     CompoundDatabase& db = CompoundDatabase::getInstance();
     
-    for (const auto& element : elements_) {
-        double atomicMass = db.getAtomicMass(element.first);
-        molarMass_ += atomicMass * element.second;
+    for (const ElementEntry& element : elements) {
+        molarMass += db.getAtomicMass(element.atomicNumber) * element.count;
     }
+    return molarMass;
+}
+
+const ElementCounts& ChemicalCompound::getElements() const {
+    return data_->elements;
+}
+
+int64_t ChemicalCompound::getElementCount(int atomicNumber) const {
+    return data_->elements.count(static_cast<uint8_t>(atomicNumber));
 }
 
-std::map<std::string, int> ChemicalCompound::getElementCount() const {
-    return elements_;
+std::map<std::string, int64_t> ChemicalCompound::getElementCount() const {
+    CompoundDatabase& db = CompoundDatabase::getInstance();
+    std::map<std::string, int64_t> counts;
+    for (const ElementEntry& element : data_->elements) {
+        counts[db.getElementSymbol(element.atomicNumber)] = element.count;
+    }
+    return counts;
 }
 
 double ChemicalCompound::getMolarMass() const {
-    return molarMass_;
+    return data_->molarMass;
 }
 
 bool ChemicalCompound::isValid() const {
-    return valid_;
+    return data_->diagnostic.ok();
+}
+
+const ParseDiagnostic& ChemicalCompound::getParseDiagnostic() const {
+    return data_->diagnostic;
 }
 
 std::string ChemicalCompound::getFormula() const {
-    return formula_;
+    return data_->formula;
 }
 
 std::string ChemicalCompound::getDisplayFormula() const {
-    std::string display = formula_;
+    std::string display = data_->formula;
     
     // Convert numbers to subscripts (simple string replacement)
     std::map<std::string, std::string> subscripts = {
@@ -145,28 +280,28 @@ std::string ChemicalCompound::getDisplayFormula() const {
 }
 
 bool ChemicalCompound::operator==(const ChemicalCompound& other) const {
-    return formula_ == other.formula_;
+    return data_ == other.data_ || data_->formula == other.data_->formula;
 }
 
 bool ChemicalCompound::operator<(const ChemicalCompound& other) const {
-    return formula_ < other.formula_;
+    return data_->formula < other.data_->formula;
 }
 
 // ChemicalEquation implementation
 
 ChemicalEquation::ChemicalEquation() : balanced_(false) {}
 
-void ChemicalEquation::addReactant(const ChemicalCompound& compound, int coefficient) {
+void ChemicalEquation::addReactant(const ChemicalCompound& compound, int64_t coefficient) {
     reactants_.emplace_back(compound, coefficient);
     balanced_ = false;
 }
 
-void ChemicalEquation::addProduct(const ChemicalCompound& compound, int coefficient) {
+void ChemicalEquation::addProduct(const ChemicalCompound& compound, int64_t coefficient) {
     products_.emplace_back(compound, coefficient);
     balanced_ = false;
 }
 
-void ChemicalEquation::setCoefficients(const std::vector<int>& coefficients) {
+void ChemicalEquation::setCoefficients(const std::vector<int64_t>& coefficients) {
     if (coefficients.size() != getTotalCompounds()) {
         throw std::invalid_argument("Number of coefficients doesn't match number of compounds");
     }
@@ -187,28 +322,35 @@ bool ChemicalEquation::isBalanced() const {
 }
 
 void ChemicalEquation::checkBalance() {
-    std::map<std::string, int> elementCount;
+    std::array<int64_t, CompoundDatabase::MAX_ATOMIC_NUMBER + 1> elementCount{};
     
-    // Add atoms from reactants
-    for (const auto& reactant : reactants_) {
-        auto elements = reactant.first.getElementCount();
-        for (const auto& element : elements) {
-            elementCount[element.first] += element.second * reactant.second;
+    // A count that overflows 64 bits cannot be verified, so it is reported
+    // as unbalanced rather than wrapping round to a false match
+    try {
+        // Add atoms from reactants
+        for (const auto& reactant : reactants_) {
+            for (const ElementEntry& element : reactant.first.getElements()) {
+                elementCount[element.atomicNumber] = checkedAdd(elementCount[element.atomicNumber],
+                    checkedMultiply(element.count, reactant.second));
+            }
         }
-    }
-    
-    // Subtract atoms from products
-    for (const auto& product : products_) {
-        auto elements = product.first.getElementCount();
-        for (const auto& element : elements) {
-            elementCount[element.first] -= element.second * product.second;
+        
+        // Subtract atoms from products
+        for (const auto& product : products_) {
+            for (const ElementEntry& element : product.first.getElements()) {
+                elementCount[element.atomicNumber] = checkedSubtract(elementCount[element.atomicNumber],
+                    checkedMultiply(element.count, product.second));
+            }
         }
+    } catch (const std::overflow_error&) {
+        balanced_ = false;
+        return;
     }
     
     // Check if all elements balance
     balanced_ = true;
-    for (const auto& element : elementCount) {
-        if (element.second != 0) {
+    for (int64_t count : elementCount) {
+        if (count != 0) {
             balanced_ = false;
             break;
         }
@@ -272,23 +414,39 @@ size_t ChemicalEquation::getTotalCompounds() const {
 }
 
 std::vector<std::string> ChemicalEquation::getAllElements() const {
-    std::set<std::string> elementSet;
+    CompoundDatabase& db = CompoundDatabase::getInstance();
+    std::vector<std::string> elements;
+    
+    for (int atomicNumber : getAllElementIds()) {
+        elements.push_back(db.getElementSymbol(atomicNumber));
+    }
+    
+    std::sort(elements.begin(), elements.end());
+    return elements;
+}
+
+std::vector<int> ChemicalEquation::getAllElementIds() const {
+    std::array<bool, CompoundDatabase::MAX_ATOMIC_NUMBER + 1> present{};
     
     for (const auto& reactant : reactants_) {
-        auto elements = reactant.first.getElementCount();
-        for (const auto& element : elements) {
-            elementSet.insert(element.first);
+        for (const ElementEntry& element : reactant.first.getElements()) {
+            present[element.atomicNumber] = true;
         }
     }
     
     for (const auto& product : products_) {
-        auto elements = product.first.getElementCount();
-        for (const auto& element : elements) {
-            elementSet.insert(element.first);
+        for (const ElementEntry& element : product.first.getElements()) {
+            present[element.atomicNumber] = true;
         }
     }
     
-    return std::vector<std::string>(elementSet.begin(), elementSet.end());
+    std::vector<int> ids;
+    for (size_t atomicNumber = 0; atomicNumber < present.size(); ++atomicNumber) {
+        if (present[atomicNumber]) {
+            ids.push_back(static_cast<int>(atomicNumber));
+        }
+    }
+    return ids;
 }
 
 void ChemicalEquation::clear() {
@@ -2,28 +2,86 @@
 #define CHEMICAL_COMPOUND_H
 
 #include <string>
+#include <string_view>
 #include <map>
 #include <vector>
 #include <set>
+#include <array>
+#include <memory>
+#include <cstdint>
+#include "ParseDiagnostic.h"
 
+class FormulaLiteral;
+
+struct ElementEntry {
+    uint8_t atomicNumber;
+    int64_t count;
+};
+
+// Element counts keyed by atomic number, kept sorted. Compounds rarely have
+// more than a handful of elements, so those live inline in the object and
+// only larger formulas spill to the heap.
+class ElementCounts {
+private:
+    static constexpr size_t INLINE_CAPACITY = 4;
+    
+    std::array<ElementEntry, INLINE_CAPACITY> inline_;
+    std::vector<ElementEntry> spill_; // holds every entry once spilled
+    uint8_t size_;
+    
+    ElementEntry* data() { return spill_.empty() ? inline_.data() : spill_.data(); }
+    const ElementEntry* data() const { return spill_.empty() ? inline_.data() : spill_.data(); }
+    
+public:
+    ElementCounts();
+    
+    // Count slot for an element, inserted as zero if not present
+    int64_t& operator[](uint8_t atomicNumber);
+    int64_t count(uint8_t atomicNumber) const;
+    
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    void clear();
+    
+    const ElementEntry* begin() const { return data(); }
+    const ElementEntry* end() const { return data() + size_; }
+};
+
+// A compound is a cheap handle to immutable parsed data. Copies share the
+// same record, which lets FormulaCache hand out one parsed instance per
+// formula and lets equations hold compounds without duplicating them.
 class ChemicalCompound {
 private:
-    std::map<std::string, int> elements_;
-    double molarMass_;
-    std::string formula_;
-    bool valid_;
-    std::string parseFormula(const std::string& formula);
-    void parseGroup(const std::string& formula, size_t start, size_t end, int multiplier);
-    void calculateMolarMass();
+    struct Data {
+        ElementCounts elements;
+        double molarMass = 0.0;
+        std::string formula;
+        ParseDiagnostic diagnostic = ParseDiagnostic::success();
+    };
+    
+    std::shared_ptr<const Data> data_;
+    
+    static ParseDiagnostic parseFormula(std::string_view formula, ElementCounts& elements);
+    static double calculateMolarMass(const ElementCounts& elements);
+    
+    friend class FormulaCache;
     
 public:
-    ChemicalCompound(const std::string& formula);
+    // Never throws: check isValid() / getParseDiagnostic() for parse errors.
+    // Parses straight from the caller's buffer; the formula text is copied
+    // once into the compound's record since the compound outlives the buffer.
+    ChemicalCompound(std::string_view formula);
+    // Adopts counts and molar mass computed at compile time, no parsing
+    ChemicalCompound(const FormulaLiteral& literal);
     ChemicalCompound(const ChemicalCompound& other) = default;
     ChemicalCompound& operator=(const ChemicalCompound& other) = default;
     
-    std::map<std::string, int> getElementCount() const;
+    const ElementCounts& getElements() const;
+    int64_t getElementCount(int atomicNumber) const;
+    std::map<std::string, int64_t> getElementCount() const; // Compatibility view keyed by symbol
     double getMolarMass() const;
     bool isValid() const;
+    const ParseDiagnostic& getParseDiagnostic() const;
     std::string getFormula() const;
     std::string getDisplayFormula() const; // With subscripts for display
     
@@ -33,16 +91,16 @@ public:
 
 class ChemicalEquation {
 private:
-    std::vector<std::pair<ChemicalCompound, int>> reactants_;
-    std::vector<std::pair<ChemicalCompound, int>> products_;
+    std::vector<std::pair<ChemicalCompound, int64_t>> reactants_;
+    std::vector<std::pair<ChemicalCompound, int64_t>> products_;
     bool balanced_;
     
 public:
     ChemicalEquation();
     
-    void addReactant(const ChemicalCompound& compound, int coefficient = 1);
-    void addProduct(const ChemicalCompound& compound, int coefficient = 1);
-    void setCoefficients(const std::vector<int>& coefficients);
+    void addReactant(const ChemicalCompound& compound, int64_t coefficient = 1);
+    void addProduct(const ChemicalCompound& compound, int64_t coefficient = 1);
+    void setCoefficients(const std::vector<int64_t>& coefficients);
     
     bool isBalanced() const;
     void checkBalance();
@@ -50,14 +108,15 @@ public:
     std::string toString() const;
     std::string toDisplayString() const; // With subscripts for display
     
-    std::vector<std::pair<ChemicalCompound, int>>& getReactants() { return reactants_; }
-    std::vector<std::pair<ChemicalCompound, int>>& getProducts() { return products_; }
+    std::vector<std::pair<ChemicalCompound, int64_t>>& getReactants() { return reactants_; }
+    std::vector<std::pair<ChemicalCompound, int64_t>>& getProducts() { return products_; }
     
-    const std::vector<std::pair<ChemicalCompound, int>>& getReactants() const { return reactants_; }
-    const std::vector<std::pair<ChemicalCompound, int>>& getProducts() const { return products_; }
+    const std::vector<std::pair<ChemicalCompound, int64_t>>& getReactants() const { return reactants_; }
+    const std::vector<std::pair<ChemicalCompound, int64_t>>& getProducts() const { return products_; }
     
     size_t getTotalCompounds() const;
     std::vector<std::string> getAllElements() const;
+    std::vector<int> getAllElementIds() const; // Sorted by atomic number
     
     void clear();
 };
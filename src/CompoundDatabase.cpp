@@ -1,114 +1,51 @@
 #include "CompoundDatabase.h"
+#include "ElementTable.h"
 #include <iostream>
+#include <mutex>
 
 CompoundDatabase* CompoundDatabase::instance_ = nullptr;
 
-CompoundDatabase::CompoundDatabase() {
+CompoundDatabase::CompoundDatabase()
+    : symbolsByNumber_(MAX_ATOMIC_NUMBER + 1)
+    , massesByNumber_(MAX_ATOMIC_NUMBER + 1, 0.0)
+    , numbersBySymbol_() {
     loadElements();
     loadCompounds();
 }
 
 CompoundDatabase& CompoundDatabase::getInstance() {
-    if (instance_ == nullptr) {
-        instance_ = new CompoundDatabase();
-    }
+    // Formulas may be parsed on several threads, construct exactly once
+    static std::once_flag initialized;
+    std::call_once(initialized, []() { instance_ = new CompoundDatabase(); });
     return *instance_;
 }
 
 void CompoundDatabase::loadElements() {
-    // Common elements with atomic masses
-    elements_["H"] = {"Hydrogen", "H", 1.008, 1, "Nonmetal"};
-    elements_["He"] = {"Helium", "He", 4.003, 2, "Noble gas"};
-    elements_["Li"] = {"Lithium", "Li", 6.941, 3, "Alkali metal"};
-    elements_["Be"] = {"Beryllium", "Be", 9.012, 4, "Alkaline earth metal"};
-    elements_["B"] = {"Boron", "B", 10.811, 5, "Metalloid"};
-    elements_["C"] = {"Carbon", "C", 12.011, 6, "Nonmetal"};
-    elements_["N"] = {"Nitrogen", "N", 14.007, 7, "Nonmetal"};
-    elements_["O"] = {"Oxygen", "O", 15.999, 8, "Nonmetal"};
-    elements_["F"] = {"Fluorine", "F", 18.998, 9, "Halogen"};
-    elements_["Ne"] = {"Neon", "Ne", 20.180, 10, "Noble gas"};
-    elements_["Na"] = {"Sodium", "Na", 22.990, 11, "Alkali metal"};
-    elements_["Mg"] = {"Magnesium", "Mg", 24.305, 12, "Alkaline earth metal"};
-    elements_["Al"] = {"Aluminum", "Al", 26.982, 13, "Metal"};
-    elements_["Si"] = {"Silicon", "Si", 28.086, 14, "Metalloid"};
-    elements_["P"] = {"Phosphorus", "P", 30.974, 15, "Nonmetal"};
-    elements_["S"] = {"Sulfur", "S", 32.066, 16, "Nonmetal"};
-    elements_["Cl"] = {"Chlorine", "Cl", 35.453, 17, "Halogen"};
-    elements_["Ar"] = {"Argon", "Ar", 39.948, 18, "Noble gas"};
-    elements_["K"] = {"Potassium", "K", 39.098, 19, "Alkali metal"};
-    elements_["Ca"] = {"Calcium", "Ca", 40.078, 20, "Alkaline earth metal"};
-    elements_["Sc"] = {"Scandium", "Sc", 44.956, 21, "Transition metal"};
-    elements_["Ti"] = {"Titanium", "Ti", 47.867, 22, "Transition metal"};
-    elements_["V"] = {"Vanadium", "V", 50.942, 23, "Transition metal"};
-    elements_["Cr"] = {"Chromium", "Cr", 51.996, 24, "Transition metal"};
-    elements_["Mn"] = {"Manganese", "Mn", 54.938, 25, "Transition metal"};
-    elements_["Fe"] = {"Iron", "Fe", 55.845, 26, "Transition metal"};
-    elements_["Co"] = {"Cobalt", "Co", 58.933, 27, "Transition metal"};
-    elements_["Ni"] = {"Nickel", "Ni", 58.693, 28, "Transition metal"};
-    elements_["Cu"] = {"Copper", "Cu", 63.546, 29, "Transition metal"};
-    elements_["Zn"] = {"Zinc", "Zn", 65.38, 30, "Transition metal"};
-    elements_["Ga"] = {"Gallium", "Ga", 69.723, 31, "Metal"};
-    elements_["Ge"] = {"Germanium", "Ge", 72.630, 32, "Metalloid"};
-    elements_["As"] = {"Arsenic", "As", 74.922, 33, "Metalloid"};
-    elements_["Se"] = {"Selenium", "Se", 78.971, 34, "Nonmetal"};
-    elements_["Br"] = {"Bromine", "Br", 79.904, 35, "Halogen"};
-    elements_["Kr"] = {"Krypton", "Kr", 83.798, 36, "Noble gas"};
-    elements_["Rb"] = {"Rubidium", "Rb", 85.468, 37, "Alkali metal"};
-    elements_["Sr"] = {"Strontium", "Sr", 87.62, 38, "Alkaline earth metal"};
-    elements_["Y"] = {"Yttrium", "Y", 88.906, 39, "Transition metal"};
-    elements_["Zr"] = {"Zirconium", "Zr", 91.224, 40, "Transition metal"};
-    elements_["Nb"] = {"Niobium", "Nb", 92.906, 41, "Transition metal"};
-    elements_["Mo"] = {"Molybdenum", "Mo", 95.95, 42, "Transition metal"};
-    elements_["Tc"] = {"Technetium", "Tc", 98.0, 43, "Transition metal"};
-    elements_["Ru"] = {"Ruthenium", "Ru", 101.07, 44, "Transition metal"};
-    elements_["Rh"] = {"Rhodium", "Rh", 102.91, 45, "Transition metal"};
-    elements_["Pd"] = {"Palladium", "Pd", 106.42, 46, "Transition metal"};
-    elements_["Ag"] = {"Silver", "Ag", 107.87, 47, "Transition metal"};
-    elements_["Cd"] = {"Cadmium", "Cd", 112.41, 48, "Transition metal"};
-    elements_["In"] = {"Indium", "In", 114.82, 49, "Metal"};
-    elements_["Sn"] = {"Tin", "Sn", 118.71, 50, "Metal"};
-    elements_["Sb"] = {"Antimony", "Sb", 121.76, 51, "Metalloid"};
-    elements_["Te"] = {"Tellurium", "Te", 127.60, 52, "Metalloid"};
-    elements_["I"] = {"Iodine", "I", 126.90, 53, "Halogen"};
-    elements_["Xe"] = {"Xenon", "Xe", 131.29, 54, "Noble gas"};
-    elements_["Cs"] = {"Cesium", "Cs", 132.91, 55, "Alkali metal"};
-    elements_["Ba"] = {"Barium", "Ba", 137.33, 56, "Alkaline earth metal"};
-    elements_["La"] = {"Lanthanum", "La", 138.91, 57, "Lanthanide"};
-    elements_["Ce"] = {"Cerium", "Ce", 140.12, 58, "Lanthanide"};
-    elements_["Pr"] = {"Praseodymium", "Pr", 140.91, 59, "Lanthanide"};
-    elements_["Nd"] = {"Neodymium", "Nd", 144.24, 60, "Lanthanide"};
-    elements_["Pm"] = {"Promethium", "Pm", 145.0, 61, "Lanthanide"};
-    elements_["Sm"] = {"Samarium", "Sm", 150.36, 62, "Lanthanide"};
-    elements_["Eu"] = {"Europium", "Eu", 151.96, 63, "Lanthanide"};
-    elements_["Gd"] = {"Gadolinium", "Gd", 157.25, 64, "Lanthanide"};
-    elements_["Tb"] = {"Terbium", "Tb", 158.93, 65, "Lanthanide"};
-    elements_["Dy"] = {"Dysprosium", "Dy", 162.50, 66, "Lanthanide"};
-    elements_["Ho"] = {"Holmium", "Ho", 164.93, 67, "Lanthanide"};
-    elements_["Er"] = {"Erbium", "Er", 167.26, 68, "Lanthanide"};
-    elements_["Tm"] = {"Thulium", "Tm", 168.93, 69, "Lanthanide"};
-    elements_["Yb"] = {"Ytterbium", "Yb", 173.04, 70, "Lanthanide"};
-    elements_["Lu"] = {"Lutetium", "Lu", 174.97, 71, "Lanthanide"};
-    elements_["Hf"] = {"Hafnium", "Hf", 178.49, 72, "Transition metal"};
-    elements_["Ta"] = {"Tantalum", "Ta", 180.95, 73, "Transition metal"};
-    elements_["W"] = {"Tungsten", "W", 183.84, 74, "Transition metal"};
-    elements_["Re"] = {"Rhenium", "Re", 186.21, 75, "Transition metal"};
-    elements_["Os"] = {"Osmium", "Os", 190.23, 76, "Transition metal"};
-    elements_["Ir"] = {"Iridium", "Ir", 192.22, 77, "Transition metal"};
-    elements_["Pt"] = {"Platinum", "Pt", 195.08, 78, "Transition metal"};
-    elements_["Au"] = {"Gold", "Au", 196.97, 79, "Transition metal"};
-    elements_["Hg"] = {"Mercury", "Hg", 200.59, 80, "Transition metal"};
-    elements_["Tl"] = {"Thallium", "Tl", 204.38, 81, "Metal"};
-    elements_["Pb"] = {"Lead", "Pb", 207.2, 82, "Metal"};
-    elements_["Bi"] = {"Bismuth", "Bi", 208.98, 83, "Metal"};
-    elements_["Po"] = {"Polonium", "Po", 209.0, 84, "Metalloid"};
-    elements_["At"] = {"Astatine", "At", 210.0, 85, "Halogen"};
-    elements_["Rn"] = {"Radon", "Rn", 222.0, 86, "Noble gas"};
-    elements_["Fr"] = {"Francium", "Fr", 223.0, 87, "Alkali metal"};
-    elements_["Ra"] = {"Radium", "Ra", 226.0, 88, "Alkaline earth metal"};
-    elements_["Ac"] = {"Actinium", "Ac", 227.0, 89, "Actinide"};
-    elements_["Th"] = {"Thorium", "Th", 232.04, 90, "Actinide"};
-    elements_["Pa"] = {"Protactinium", "Pa", 231.04, 91, "Actinide"};
-    elements_["U"] = {"Uranium", "U", 238.03, 92, "Actinide"};
+    for (const ElementRecord& record : ELEMENT_TABLE) {
+        elements_[record.symbol] = {record.name, record.symbol, record.atomicMass, record.atomicNumber, record.category};
+    }
+    
+    for (const auto& element : elements_) {
+        const ElementData& data = element.second;
+        symbolsByNumber_[data.atomicNumber] = data.symbol;
+        massesByNumber_[data.atomicNumber] = data.atomicMass;
+        numbersBySymbol_[symbolSlot(data.symbol)] = static_cast<uint8_t>(data.atomicNumber);
+    }
+}
+
+int CompoundDatabase::symbolSlot(std::string_view symbol) {
+    // One uppercase letter plus an optional lowercase one: 26 * 27 slots
+    if (symbol.empty() || symbol.size() > 2 || symbol[0] < 'A' || symbol[0] > 'Z') {
+        return -1;
+    }
+    int slot = (symbol[0] - 'A') * 27;
+    if (symbol.size() == 2) {
+        if (symbol[1] < 'a' || symbol[1] > 'z') {
+            return -1;
+        }
+        slot += symbol[1] - 'a' + 1;
+    }
+    return slot;
 }
 
 void CompoundDatabase::loadCompounds() {
@@ -166,6 +103,26 @@ double CompoundDatabase::getAtomicMass(const std::string& element) const {
     return 0.0;
 }
 
+double CompoundDatabase::getAtomicMass(int atomicNumber) const {
+    if (atomicNumber <= 0 || atomicNumber > MAX_ATOMIC_NUMBER) {
+        return 0.0;
+    }
+    return massesByNumber_[atomicNumber];
+}
+
+int CompoundDatabase::getAtomicNumber(std::string_view symbol) const {
+    int slot = symbolSlot(symbol);
+    return slot < 0 ? 0 : numbersBySymbol_[slot];
+}
+
+const std::string& CompoundDatabase::getElementSymbol(int atomicNumber) const {
+    static const std::string unknown;
+    if (atomicNumber <= 0 || atomicNumber > MAX_ATOMIC_NUMBER) {
+        return unknown;
+    }
+    return symbolsByNumber_[atomicNumber];
+}
+
 ElementData CompoundDatabase::getElementData(const std::string& element) const {
     auto it = elements_.find(element);
     if (it != elements_.end()) {
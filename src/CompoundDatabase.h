@@ -4,6 +4,9 @@
 #include <string>
 #include <map>
 #include <vector>
+#include <array>
+#include <string_view>
+#include <cstdint>
 
 struct ElementData {
     std::string name;
@@ -29,14 +32,28 @@ private:
     std::map<std::string, CompoundData> compounds_;
     static CompoundDatabase* instance_;
     
+    // Flat lookup tables indexed by atomic number and by packed symbol
+    std::vector<std::string> symbolsByNumber_;
+    std::vector<double> massesByNumber_;
+    std::array<uint8_t, 26 * 27> numbersBySymbol_;
+    
+    static int symbolSlot(std::string_view symbol);
+    
     CompoundDatabase();
     void loadElements();
     void loadCompounds();
     
 public:
+    static constexpr int MAX_ATOMIC_NUMBER = 118;
+    
     static CompoundDatabase& getInstance();
     
     double getAtomicMass(const std::string& element) const;
+    double getAtomicMass(int atomicNumber) const;
+    
+    // Interned element ids: 0 when the symbol is not a known element
+    int getAtomicNumber(std::string_view symbol) const;
+    const std::string& getElementSymbol(int atomicNumber) const;
     ElementData getElementData(const std::string& element) const;
     CompoundData getCompoundData(const std::string& formula) const;
     
@@ -0,0 +1,127 @@
+#ifndef DENSE_MATRIX_H
+#define DENSE_MATRIX_H
+
+#include "RowKernels.h"
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+// View of one matrix row: a pointer and a length. Valid until the matrix it
+// came from is resized, assigned or destroyed.
+template <typename T>
+class MatrixRow {
+private:
+    T* data_;
+    size_t size_;
+
+public:
+    MatrixRow(T* data, size_t size) : data_(data), size_(size) {}
+
+    T& operator[](size_t col) const { return data_[col]; }
+    size_t size() const { return size_; }
+    T* data() const { return data_; }
+    T* begin() const { return data_; }
+    T* end() const { return data_ + size_; }
+};
+
+// Row-major matrix in a single contiguous buffer: element (row, col) lives at
+// data()[row * stride() + col]. Copying a matrix is one allocation however
+// many rows it has, and row operations walk memory linearly.
+template <typename T>
+class DenseMatrix {
+private:
+    std::vector<T> data_;
+    size_t rows_;
+    size_t cols_;
+
+    static T magnitude(const T& value) { return value < T() ? -value : value; }
+
+public:
+    DenseMatrix() : rows_(0), cols_(0) {}
+    DenseMatrix(size_t rows, size_t cols, const T& value = T()) : data_(rows * cols, value), rows_(rows), cols_(cols) {}
+
+    // Element-wise conversion, e.g. an exact int64_t matrix to double
+    template <typename U>
+    explicit DenseMatrix(const DenseMatrix<U>& other)
+        : data_(other.data(), other.data() + other.rows() * other.cols()), rows_(other.rows()), cols_(other.cols()) {}
+
+    // Reshapes and fills, reusing the buffer when it is already large enough
+    void assign(size_t rows, size_t cols, const T& value = T()) {
+        data_.assign(rows * cols, value);
+        rows_ = rows;
+        cols_ = cols;
+    }
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    size_t stride() const { return cols_; }
+    bool empty() const { return rows_ == 0 || cols_ == 0; }
+
+    T& operator()(size_t row, size_t col) { return data_[row * cols_ + col]; }
+    const T& operator()(size_t row, size_t col) const { return data_[row * cols_ + col]; }
+
+    // matrix[row][col], so elimination code reads as it would on nested vectors
+    MatrixRow<T> operator[](size_t row) { return MatrixRow<T>(data_.data() + row * cols_, cols_); }
+    MatrixRow<const T> operator[](size_t row) const { return MatrixRow<const T>(data_.data() + row * cols_, cols_); }
+    MatrixRow<T> row(size_t row) { return (*this)[row]; }
+    MatrixRow<const T> row(size_t row) const { return (*this)[row]; }
+
+    T* data() { return data_.data(); }
+    const T* data() const { return data_.data(); }
+
+    void swapRows(size_t row1, size_t row2) {
+        if (row1 != row2) {
+            std::swap_ranges(data_.data() + row1 * cols_, data_.data() + (row1 + 1) * cols_, data_.data() + row2 * cols_);
+        }
+    }
+
+    void scaleRow(size_t row, const T& factor) {
+        T* values = data_.data() + row * cols_;
+        for (size_t col = 0; col < cols_; ++col) {
+            values[col] *= factor;
+        }
+    }
+
+    // target += factor * source; the rows are plain arrays, so this is an axpy
+    void addScaledRow(size_t source, size_t target, const T& factor) {
+        const T* from = data_.data() + source * cols_;
+        T* to = data_.data() + target * cols_;
+        for (size_t col = 0; col < cols_; ++col) {
+            to[col] += factor * from[col];
+        }
+    }
+
+    // Row of the first entry of largest magnitude in col at or below fromRow
+    size_t largestInColumn(size_t col, size_t fromRow) const {
+        size_t best = fromRow;
+        for (size_t row = fromRow + 1; row < rows_; ++row) {
+            if (magnitude((*this)(row, col)) > magnitude((*this)(best, col))) {
+                best = row;
+            }
+        }
+        return best;
+    }
+
+    bool operator==(const DenseMatrix& other) const {
+        return rows_ == other.rows_ && cols_ == other.cols_ && data_ == other.data_;
+    }
+    bool operator!=(const DenseMatrix& other) const { return !(*this == other); }
+};
+
+// The floating-point solvers spend their time in these three loops
+template <>
+inline void DenseMatrix<double>::scaleRow(size_t row, const double& factor) {
+    RowKernels::scale(data_.data() + row * cols_, cols_, factor);
+}
+
+template <>
+inline void DenseMatrix<double>::addScaledRow(size_t source, size_t target, const double& factor) {
+    RowKernels::axpy(data_.data() + target * cols_, data_.data() + source * cols_, cols_, factor);
+}
+
+template <>
+inline size_t DenseMatrix<double>::largestInColumn(size_t col, size_t fromRow) const {
+    return fromRow + RowKernels::maxAbsIndex(data_.data() + fromRow * cols_ + col, rows_ - fromRow, cols_);
+}
+
+#endif // DENSE_MATRIX_H
@@ -0,0 +1,140 @@
+#ifndef ELEMENT_TABLE_H
+#define ELEMENT_TABLE_H
+
+#include <string_view>
+#include <cstddef>
+
+struct ElementRecord {
+    const char* name;
+    const char* symbol;
+    double atomicMass;
+    int atomicNumber;
+    const char* category;
+};
+
+// Element data shared by CompoundDatabase and the compile-time formula
+// literals, ordered by atomic number
+inline constexpr ElementRecord ELEMENT_TABLE[] = {
+    {"Hydrogen", "H", 1.008, 1, "Nonmetal"},
+    {"Helium", "He", 4.003, 2, "Noble gas"},
+    {"Lithium", "Li", 6.941, 3, "Alkali metal"},
+    {"Beryllium", "Be", 9.012, 4, "Alkaline earth metal"},
+    {"Boron", "B", 10.811, 5, "Metalloid"},
+    {"Carbon", "C", 12.011, 6, "Nonmetal"},
+    {"Nitrogen", "N", 14.007, 7, "Nonmetal"},
+    {"Oxygen", "O", 15.999, 8, "Nonmetal"},
+    {"Fluorine", "F", 18.998, 9, "Halogen"},
+    {"Neon", "Ne", 20.180, 10, "Noble gas"},
+    {"Sodium", "Na", 22.990, 11, "Alkali metal"},
+    {"Magnesium", "Mg", 24.305, 12, "Alkaline earth metal"},
+    {"Aluminum", "Al", 26.982, 13, "Metal"},
+    {"Silicon", "Si", 28.086, 14, "Metalloid"},
+    {"Phosphorus", "P", 30.974, 15, "Nonmetal"},
+    {"Sulfur", "S", 32.066, 16, "Nonmetal"},
+    {"Chlorine", "Cl", 35.453, 17, "Halogen"},
+    {"Argon", "Ar", 39.948, 18, "Noble gas"},
+    {"Potassium", "K", 39.098, 19, "Alkali metal"},
+    {"Calcium", "Ca", 40.078, 20, "Alkaline earth metal"},
+    {"Scandium", "Sc", 44.956, 21, "Transition metal"},
+    {"Titanium", "Ti", 47.867, 22, "Transition metal"},
+    {"Vanadium", "V", 50.942, 23, "Transition metal"},
+    {"Chromium", "Cr", 51.996, 24, "Transition metal"},
+    {"Manganese", "Mn", 54.938, 25, "Transition metal"},
+    {"Iron", "Fe", 55.845, 26, "Transition metal"},
+    {"Cobalt", "Co", 58.933, 27, "Transition metal"},
+    {"Nickel", "Ni", 58.693, 28, "Transition metal"},
+    {"Copper", "Cu", 63.546, 29, "Transition metal"},
+    {"Zinc", "Zn", 65.38, 30, "Transition metal"},
+    {"Gallium", "Ga", 69.723, 31, "Metal"},
+    {"Germanium", "Ge", 72.630, 32, "Metalloid"},
+    {"Arsenic", "As", 74.922, 33, "Metalloid"},
+    {"Selenium", "Se", 78.971, 34, "Nonmetal"},
+    {"Bromine", "Br", 79.904, 35, "Halogen"},
+    {"Krypton", "Kr", 83.798, 36, "Noble gas"},
+    {"Rubidium", "Rb", 85.468, 37, "Alkali metal"},
+    {"Strontium", "Sr", 87.62, 38, "Alkaline earth metal"},
+    {"Yttrium", "Y", 88.906, 39, "Transition metal"},
+    {"Zirconium", "Zr", 91.224, 40, "Transition metal"},
+    {"Niobium", "Nb", 92.906, 41, "Transition metal"},
+    {"Molybdenum", "Mo", 95.95, 42, "Transition metal"},
+    {"Technetium", "Tc", 98.0, 43, "Transition metal"},
+    {"Ruthenium", "Ru", 101.07, 44, "Transition metal"},
+    {"Rhodium", "Rh", 102.91, 45, "Transition metal"},
+    {"Palladium", "Pd", 106.42, 46, "Transition metal"},
+    {"Silver", "Ag", 107.87, 47, "Transition metal"},
+    {"Cadmium", "Cd", 112.41, 48, "Transition metal"},
+    {"Indium", "In", 114.82, 49, "Metal"},
+    {"Tin", "Sn", 118.71, 50, "Metal"},
+    {"Antimony", "Sb", 121.76, 51, "Metalloid"},
+    {"Tellurium", "Te", 127.60, 52, "Metalloid"},
+    {"Iodine", "I", 126.90, 53, "Halogen"},
+    {"Xenon", "Xe", 131.29, 54, "Noble gas"},
+    {"Cesium", "Cs", 132.91, 55, "Alkali metal"},
+    {"Barium", "Ba", 137.33, 56, "Alkaline earth metal"},
+    {"Lanthanum", "La", 138.91, 57, "Lanthanide"},
+    {"Cerium", "Ce", 140.12, 58, "Lanthanide"},
+    {"Praseodymium", "Pr", 140.91, 59, "Lanthanide"},
+    {"Neodymium", "Nd", 144.24, 60, "Lanthanide"},
+    {"Promethium", "Pm", 145.0, 61, "Lanthanide"},
+    {"Samarium", "Sm", 150.36, 62, "Lanthanide"},
+    {"Europium", "Eu", 151.96, 63, "Lanthanide"},
+    {"Gadolinium", "Gd", 157.25, 64, "Lanthanide"},
+    {"Terbium", "Tb", 158.93, 65, "Lanthanide"},
+    {"Dysprosium", "Dy", 162.50, 66, "Lanthanide"},
+    {"Holmium", "Ho", 164.93, 67, "Lanthanide"},
+    {"Erbium", "Er", 167.26, 68, "Lanthanide"},
+    {"Thulium", "Tm", 168.93, 69, "Lanthanide"},
+    {"Ytterbium", "Yb", 173.04, 70, "Lanthanide"},
+    {"Lutetium", "Lu", 174.97, 71, "Lanthanide"},
+    {"Hafnium", "Hf", 178.49, 72, "Transition metal"},
+    {"Tantalum", "Ta", 180.95, 73, "Transition metal"},
+    {"Tungsten", "W", 183.84, 74, "Transition metal"},
+    {"Rhenium", "Re", 186.21, 75, "Transition metal"},
+    {"Osmium", "Os", 190.23, 76, "Transition metal"},
+    {"Iridium", "Ir", 192.22, 77, "Transition metal"},
+    {"Platinum", "Pt", 195.08, 78, "Transition metal"},
+    {"Gold", "Au", 196.97, 79, "Transition metal"},
+    {"Mercury", "Hg", 200.59, 80, "Transition metal"},
+    {"Thallium", "Tl", 204.38, 81, "Metal"},
+    {"Lead", "Pb", 207.2, 82, "Metal"},
+    {"Bismuth", "Bi", 208.98, 83, "Metal"},
+    {"Polonium", "Po", 209.0, 84, "Metalloid"},
+    {"Astatine", "At", 210.0, 85, "Halogen"},
+    {"Radon", "Rn", 222.0, 86, "Noble gas"},
+    {"Francium", "Fr", 223.0, 87, "Alkali metal"},
+    {"Radium", "Ra", 226.0, 88, "Alkaline earth metal"},
+    {"Actinium", "Ac", 227.0, 89, "Actinide"},
+    {"Thorium", "Th", 232.04, 90, "Actinide"},
+    {"Protactinium", "Pa", 231.04, 91, "Actinide"},
+    {"Uranium", "U", 238.03, 92, "Actinide"},
+};
+
+inline constexpr size_t ELEMENT_TABLE_SIZE = sizeof(ELEMENT_TABLE) / sizeof(ELEMENT_TABLE[0]);
+
+constexpr bool elementTableIsOrdered() {
+    for (size_t i = 0; i < ELEMENT_TABLE_SIZE; ++i) {
+        if (ELEMENT_TABLE[i].atomicNumber != static_cast<int>(i) + 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(elementTableIsOrdered(), "ELEMENT_TABLE must be indexed by atomic number");
+
+// Constant-expression counterpart of CompoundDatabase::getAtomicNumber
+constexpr int findAtomicNumber(std::string_view symbol) {
+    for (const ElementRecord& element : ELEMENT_TABLE) {
+        if (symbol == element.symbol) {
+            return element.atomicNumber;
+        }
+    }
+    return 0;
+}
+
+constexpr double findAtomicMass(int atomicNumber) {
+    return atomicNumber >= 1 && static_cast<size_t>(atomicNumber) <= ELEMENT_TABLE_SIZE
+        ? ELEMENT_TABLE[atomicNumber - 1].atomicMass : 0.0;
+}
+
+#endif // ELEMENT_TABLE_H
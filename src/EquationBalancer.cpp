@@ -1,53 +1,89 @@
 #include "EquationBalancer.h"
+#include "CompoundDatabase.h"
+#include "FormulaCache.h"
+#include "CheckedArithmetic.h"
 #include <iostream>
 #include <sstream>
-#include <regex>
+#include <limits>
+#include <array>
 #include <algorithm>
 #include <iomanip>
+#include <cmath>
+#include <stdexcept>
 
-std::vector<std::vector<double>> EquationBalancer::buildStoichiometricMatrix(const ChemicalEquation& equation) {
-    auto elements = equation.getAllElements();
-    auto reactants = equation.getReactants();
-    auto products = equation.getProducts();
-    
-    int numElements = elements.size();
-    int numCompounds = reactants.size() + products.size();
-    
-    std::vector<std::vector<double>> matrix(numElements, std::vector<double>(numCompounds, 0.0));
-    
-    addBalancingStep("Building stoichiometric matrix for elements: " + 
-                    [&elements]() {
-                        std::string result;
-                        for (size_t i = 0; i < elements.size(); ++i) {
-                            if (i > 0) result += ", ";
-                            result += elements[i];
-                        }
-                        return result;
-                    }());
+void EquationBalancer::fillStoichiometricMatrix(const ChemicalEquation& equation, const std::vector<std::string>& elements,
+                                                DenseMatrix<double>& matrix) {
+    const auto& reactants = equation.getReactants();
+    const auto& products = equation.getProducts();
+    
+    matrix.assign(elements.size(), reactants.size() + products.size(), 0.0);
+    
+    // Map interned element ids to matrix rows
+    CompoundDatabase& db = CompoundDatabase::getInstance();
+    std::array<int, CompoundDatabase::MAX_ATOMIC_NUMBER + 1> rowOf{};
+    for (size_t elemIndex = 0; elemIndex < elements.size(); ++elemIndex) {
+        rowOf[db.getAtomicNumber(elements[elemIndex])] = static_cast<int>(elemIndex);
+    }
     
     // Fill matrix for reactants (positive coefficients in matrix)
     for (size_t compIndex = 0; compIndex < reactants.size(); ++compIndex) {
-        auto elementCount = reactants[compIndex].first.getElementCount();
-        
-        for (size_t elemIndex = 0; elemIndex < elements.size(); ++elemIndex) {
-            auto it = elementCount.find(elements[elemIndex]);
-            if (it != elementCount.end()) {
-                matrix[elemIndex][compIndex] = it->second;
-            }
+        for (const ElementEntry& element : reactants[compIndex].first.getElements()) {
+            matrix[rowOf[element.atomicNumber]][compIndex] = element.count;
         }
     }
     
     // Fill matrix for products (negative coefficients in matrix)
     for (size_t compIndex = 0; compIndex < products.size(); ++compIndex) {
-        auto elementCount = products[compIndex].first.getElementCount();
-        
-        for (size_t elemIndex = 0; elemIndex < elements.size(); ++elemIndex) {
-            auto it = elementCount.find(elements[elemIndex]);
-            if (it != elementCount.end()) {
-                matrix[elemIndex][reactants.size() + compIndex] = -it->second;
-            }
+        for (const ElementEntry& element : products[compIndex].first.getElements()) {
+            matrix[rowOf[element.atomicNumber]][reactants.size() + compIndex] = -element.count;
+        }
+    }
+}
+
+void EquationBalancer::fillExactMatrix(const ChemicalEquation& equation, DenseMatrix<int64_t>& matrix) {
+    const auto& reactants = equation.getReactants();
+    const auto& products = equation.getProducts();
+    std::vector<int> elementIds = equation.getAllElementIds();
+    
+    matrix.assign(elementIds.size(), reactants.size() + products.size(), 0);
+    
+    std::array<int, CompoundDatabase::MAX_ATOMIC_NUMBER + 1> rowOf{};
+    for (size_t elemIndex = 0; elemIndex < elementIds.size(); ++elemIndex) {
+        rowOf[elementIds[elemIndex]] = static_cast<int>(elemIndex);
+    }
+    
+    for (size_t compIndex = 0; compIndex < reactants.size(); ++compIndex) {
+        for (const ElementEntry& element : reactants[compIndex].first.getElements()) {
+            matrix[rowOf[element.atomicNumber]][compIndex] = element.count;
+        }
+    }
+    for (size_t compIndex = 0; compIndex < products.size(); ++compIndex) {
+        for (const ElementEntry& element : products[compIndex].first.getElements()) {
+            matrix[rowOf[element.atomicNumber]][reactants.size() + compIndex] = -element.count;
         }
     }
+}
+
+DenseMatrix<double> EquationBalancer::buildStoichiometricMatrix(const ChemicalEquation& equation) {
+    auto elements = equation.getAllElements();
+    
+    int numElements = elements.size();
+    int numCompounds = equation.getReactants().size() + equation.getProducts().size();
+    
+    if (recordSteps_) {
+        addBalancingStep("Building stoichiometric matrix for elements: " + 
+                        [&elements]() {
+                            std::string result;
+                            for (size_t i = 0; i < elements.size(); ++i) {
+                                if (i > 0) result += ", ";
+                                result += elements[i];
+                            }
+                            return result;
+                        }());
+    }
+    
+    DenseMatrix<double> matrix;
+    fillStoichiometricMatrix(equation, elements, matrix);
     
     addBalancingStep("Matrix constructed with " + std::to_string(numElements) + 
                     " equations and " + std::to_string(numCompounds) + " unknowns");
@@ -55,11 +91,105 @@ std::vector<std::vector<double>> EquationBalancer::buildStoichiometricMatrix(con
     return matrix;
 }
 
+bool EquationBalancer::solveSmall(const ChemicalEquation& equation, std::vector<std::vector<int64_t>>& basis) {
+    const auto& reactants = equation.getReactants();
+    const auto& products = equation.getProducts();
+    size_t cols = reactants.size() + products.size();
+    if (cols > smallSolver_.MAX_COLS) {
+        return false;
+    }
+    
+    // Rows in order of first appearance; any order gives the same basis
+    std::array<int8_t, CompoundDatabase::MAX_ATOMIC_NUMBER + 1> rowOf;
+    rowOf.fill(-1);
+    size_t rows = 0;
+    for (const auto* side : {&reactants, &products}) {
+        for (const auto& compound : *side) {
+            for (const ElementEntry& element : compound.first.getElements()) {
+                if (rowOf[element.atomicNumber] < 0) {
+                    if (rows == smallSolver_.MAX_ROWS) {
+                        return false;
+                    }
+                    rowOf[element.atomicNumber] = static_cast<int8_t>(rows++);
+                }
+            }
+        }
+    }
+    
+    smallSolver_.reset(rows, cols);
+    for (size_t compIndex = 0; compIndex < reactants.size(); ++compIndex) {
+        for (const ElementEntry& element : reactants[compIndex].first.getElements()) {
+            smallSolver_.at(rowOf[element.atomicNumber], compIndex) = element.count;
+        }
+    }
+    for (size_t compIndex = 0; compIndex < products.size(); ++compIndex) {
+        for (const ElementEntry& element : products[compIndex].first.getElements()) {
+            smallSolver_.at(rowOf[element.atomicNumber], reactants.size() + compIndex) = -element.count;
+        }
+    }
+    
+    size_t nullity;
+    try {
+        nullity = smallSolver_.solve();
+    } catch (const std::overflow_error&) {
+        return false;
+    }
+    
+    basis.clear();
+    for (size_t k = 0; k < nullity; ++k) {
+        const auto& vector = smallSolver_.basisVector(k);
+        basis.emplace_back(vector.begin(), vector.begin() + cols);
+    }
+    return true;
+}
+
+EquationBalancer::EquationBalancer(SolverMode mode) : solverMode_(mode), recordSteps_(true), smallSolverEnabled_(true) {}
+
+void EquationBalancer::setSolverMode(SolverMode mode) {
+    solverMode_ = mode;
+}
+
+SolverMode EquationBalancer::getSolverMode() const {
+    return solverMode_;
+}
+
+void EquationBalancer::setRecordSteps(bool record) {
+    recordSteps_ = record;
+    solver_.setRecordSteps(record);
+}
+
+bool EquationBalancer::isRecordingSteps() const {
+    return recordSteps_;
+}
+
+void EquationBalancer::setSmallSolverEnabled(bool enabled) {
+    smallSolverEnabled_ = enabled;
+}
+
+bool EquationBalancer::isSmallSolverEnabled() const {
+    return smallSolverEnabled_;
+}
+
+void EquationBalancer::setMinimalSearchBudget(size_t nodes) {
+    latticeSolver_.setSearchBudget(nodes);
+}
+
+size_t EquationBalancer::getMinimalSearchBudget() const {
+    return latticeSolver_.getSearchBudget();
+}
+
+int EquationBalancer::solutionDimension(const ChemicalEquation& equation) {
+    fillStoichiometricMatrix(equation, equation.getAllElements(), precheckMatrix_);
+    return solver_.nullity(precheckMatrix_);
+}
+
 void EquationBalancer::addBalancingStep(const std::string& step) {
-    balancingSteps_.push_back(step);
+    if (recordSteps_) {
+        balancingSteps_.push_back(step);
+    }
 }
 
-std::string EquationBalancer::formatMatrix(const std::vector<std::vector<double>>& matrix, 
+std::string EquationBalancer::formatMatrix(const DenseMatrix<double>& matrix, 
                                          const std::vector<std::string>& elements, 
                                          const ChemicalEquation& equation) {
     std::stringstream ss;
@@ -78,9 +208,9 @@ std::string EquationBalancer::formatMatrix(const std::vector<std::vector<double>
     ss << "\n";
     
     // Matrix rows with element labels
-    for (size_t row = 0; row < matrix.size(); ++row) {
+    for (size_t row = 0; row < matrix.rows(); ++row) {
         ss << std::setw(4) << elements[row] << " │";
-        for (size_t col = 0; col < matrix[row].size(); ++col) {
+        for (size_t col = 0; col < matrix.cols(); ++col) {
             ss << std::setw(7) << std::fixed << std::setprecision(0) << matrix[row][col] << " ";
         }
         ss << "│ = 0\n";
@@ -96,9 +226,12 @@ BalanceInfo EquationBalancer::balance(ChemicalEquation& equation) {
     BalanceInfo info;
     info.result = BalanceResult::SUCCESS;
     info.conservationVerified = false;
+    info.nullity = 0;
     
     addBalancingStep("Starting equation balancing process");
-    addBalancingStep("Original equation: " + equation.toString());
+    if (recordSteps_) {
+        addBalancingStep("Original equation: " + equation.toString());
+    }
     
     // Check if already balanced
     if (equation.isBalanced()) {
@@ -119,49 +252,206 @@ BalanceInfo EquationBalancer::balance(ChemicalEquation& equation) {
     }
     
     try {
-        // Build stoichiometric matrix
-        auto matrix = buildStoichiometricMatrix(equation);
-        auto elements = equation.getAllElements();
+        std::vector<std::vector<int64_t>> basis;
+        // Exact basis from the modular solver when it does not fit 64 bits
+        std::vector<std::vector<BigInteger>> largeBasis;
+        
+        // Small equations skip the heap-allocated matrices entirely; with
+        // steps recorded the generic path runs so the journal is complete
+        bool solved = solverMode_ == SolverMode::EXACT_INTEGER && !recordSteps_ && smallSolverEnabled_ &&
+                      solveSmall(equation, basis);
+        
+        // The exact modes read the counts as integers, so counts beyond 2^53
+        // survive; the double matrix is only for display and floating point
+        DenseMatrix<double> matrix;
+        if (!solved && (recordSteps_ || solverMode_ == SolverMode::FLOATING_POINT)) {
+            matrix = buildStoichiometricMatrix(equation);
+        }
         
-        addBalancingStep("Stoichiometric matrix:");
-        addBalancingStep(formatMatrix(matrix, elements, equation));
+        if (recordSteps_) {
+            addBalancingStep("Stoichiometric matrix:");
+            addBalancingStep(formatMatrix(matrix, equation.getAllElements(), equation));
+        }
+        
+        DenseMatrix<int64_t> exactMatrix;
+        if (!solved && solverMode_ != SolverMode::FLOATING_POINT) {
+            fillExactMatrix(equation, exactMatrix);
+        }
+        
+        if (!solved && solverMode_ == SolverMode::MIXED_PRECISION) {
+            // Rounded floating-point answers are only kept once an exact
+            // product with the matrix confirms them
+            addBalancingStep("Solving in floating point and verifying the integer candidates exactly");
+            solved = mixedSolver_.nullspaceBasis(exactMatrix, basis);
+            if (solved) {
+                addBalancingStep(std::string("Verified the ") +
+                                 (mixedSolver_.precision() == FloatPrecision::SINGLE ? "single" : "double") +
+                                 " precision solution exactly");
+            } else {
+                addBalancingStep("Floating-point candidates failed exact verification, escalating to exact elimination");
+            }
+        }
         
-        // Solve using Gaussian elimination
-        addBalancingStep("Solving system of linear equations using Gaussian elimination");
+        if (!solved && solverMode_ != SolverMode::FLOATING_POINT) {
+            addBalancingStep("Solving system of linear equations exactly using fraction-free (Bareiss) elimination");
+            
+            try {
+                try {
+                    // Bareiss reduces in place; the modular retry needs the original
+                    DenseMatrix<int64_t> workMatrix = exactMatrix;
+                    basis = solver_.nullspaceBasis(workMatrix);
+                } catch (const std::overflow_error& e) {
+                    addBalancingStep(std::string(e.what()) + ", solving modulo 62-bit primes instead");
+                    
+                    basis.clear();
+                    largeBasis = modularSolver_.nullspaceBasis(exactMatrix);
+                    addBalancingStep("Reconstructed from " + std::to_string(modularSolver_.primesUsed()) +
+                                     " primes by Chinese remaindering and verified exactly");
+                    
+                    bool fits = std::all_of(largeBasis.begin(), largeBasis.end(), [](const std::vector<BigInteger>& vector) {
+                        return std::all_of(vector.begin(), vector.end(), [](const BigInteger& value) { return value.fitsInt64(); });
+                    });
+                    if (fits) {
+                        for (const auto& vector : largeBasis) {
+                            std::vector<int64_t> values;
+                            for (const BigInteger& value : vector) {
+                                values.push_back(value.toInt64());
+                            }
+                            basis.push_back(values);
+                        }
+                        largeBasis.clear();
+                    } else {
+                        addBalancingStep("Coefficients exceed 64 bits, kept as arbitrary-precision integers");
+                    }
+                }
+                solved = true;
+                
+            } catch (const std::overflow_error& e) {
+                addBalancingStep(std::string(e.what()) + ", falling back to floating point");
+            }
+        }
         
-        auto solution = solver_.gaussianElimination(matrix);
+        if (!solved) {
+            // Solve using Gauss-Jordan elimination
+            addBalancingStep("Solving system of linear equations using Gauss-Jordan elimination");
+            
+            if (matrix.empty()) {
+                matrix = buildStoichiometricMatrix(equation);
+            }
+            basis.clear();
+            for (const auto& solution : solver_.nullspaceBasis(matrix)) {
+                if (recordSteps_) {
+                    addBalancingStep("Raw solution found: " + 
+                                    [&solution]() {
+                                        std::stringstream ss;
+                                        for (size_t i = 0; i < solution.size(); ++i) {
+                                            if (i > 0) ss << ", ";
+                                            ss << std::fixed << std::setprecision(3) << solution[i];
+                                        }
+                                        return ss.str();
+                                    }());
+                }
+                
+                std::vector<int64_t> integers;
+                try {
+                    integers = solver_.reduceToIntegers(solution);
+                } catch (const std::overflow_error& e) {
+                    info.result = BalanceResult::COEFFICIENT_OVERFLOW;
+                    info.message = "The coefficients do not fit in 64 bits: " + std::string(e.what());
+                    addBalancingStep("ERROR: " + info.message);
+                    return info;
+                }
+                basis.push_back(integers);
+            }
+        }
         
-        if (solution.empty()) {
+        // Exact coefficients beyond 64 bits are reported as they are; they
+        // cannot be applied to the equation, and floating point would only
+        // lose them
+        if (largeBasis.size() == 1) {
+            const std::vector<BigInteger>& coefficients = largeBasis[0];
+            info.nullity = 1;
+            info.largeSubReactions = largeBasis;
+            if (!std::all_of(coefficients.begin(), coefficients.end(), [](const BigInteger& value) { return value.sign() > 0; })) {
+                info.result = BalanceResult::NO_SOLUTION;
+                info.message = "Invalid coefficients found (zero or negative)";
+                return info;
+            }
+            
+            // The modular solver checked A x = 0 with exact integers
+            info.result = BalanceResult::COEFFICIENT_OVERFLOW;
+            info.largeCoefficients = coefficients;
+            info.conservationVerified = true;
+            info.message = "Balanced, but the coefficients exceed 64 bits: " + formatSubReaction(equation, coefficients);
+            addBalancingStep("Exact balanced equation: " + formatSubReaction(equation, coefficients));
+            return info;
+        }
+        
+        info.nullity = largeBasis.empty() ? basis.size() : largeBasis.size();
+        info.subReactions = basis;
+        info.largeSubReactions = largeBasis;
+        
+        if (info.nullity == 0) {
             info.result = BalanceResult::NO_SOLUTION;
             info.message = "No solution exists for this equation";
             return info;
         }
         
-        addBalancingStep("Raw solution found: " + 
-                        [&solution]() {
-                            std::stringstream ss;
-                            for (size_t i = 0; i < solution.size(); ++i) {
-                                if (i > 0) ss << ", ";
-                                ss << std::fixed << std::setprecision(3) << solution[i];
-                            }
-                            return ss.str();
-                        }());
+        // More than one independent reaction: any positive combination
+        // balances, so there is no single answer to report
+        if (info.nullity > 1) {
+            info.result = BalanceResult::INFINITE_SOLUTIONS;
+            info.message = "Infinitely many solutions: the equation combines " + std::to_string(info.nullity) +
+                           " independent reactions";
+            for (size_t i = 0; i < info.nullity; ++i) {
+                std::string reaction = largeBasis.empty() ? formatSubReaction(equation, basis[i])
+                                                          : formatSubReaction(equation, largeBasis[i]);
+                info.message += (i == 0 ? ": " : "; ") + reaction;
+                addBalancingStep("Independent reaction " + std::to_string(i + 1) + ": " + reaction);
+            }
+            
+            // The basis vectors are one arbitrary choice; the lattice search
+            // finds the combination with the smallest coefficients
+            if (latticeSolver_.getSearchBudget() == 0) {
+                return info;
+            }
+            try {
+                // The exact and mixed modes already filled the matrix
+                if (exactMatrix.empty()) {
+                    fillExactMatrix(equation, exactMatrix);
+                }
+                info.coefficients = latticeSolver_.minimalPositive(exactMatrix);
+            } catch (const std::overflow_error& e) {
+                addBalancingStep(std::string(e.what()) + " in the smallest combination search");
+            }
+            if (!info.coefficients.empty()) {
+                std::string reaction = formatSubReaction(equation, info.coefficients);
+                info.message += ". Smallest combination: " + reaction;
+                if (!latticeSolver_.isProvenMinimal()) {
+                    info.message += " (search budget reached, may not be minimal)";
+                }
+                addBalancingStep("Smallest positive combination after " + std::to_string(latticeSolver_.nodesVisited()) +
+                                 " search nodes: " + reaction);
+            }
+            return info;
+        }
         
-        // Convert to integers
-        auto integerCoeffs = solver_.reduceToIntegers(solution);
+        const std::vector<int64_t>& integerCoeffs = basis[0];
         
-        addBalancingStep("Converting to smallest integer coefficients: " +
-                        [&integerCoeffs]() {
-                            std::stringstream ss;
-                            for (size_t i = 0; i < integerCoeffs.size(); ++i) {
-                                if (i > 0) ss << ", ";
-                                ss << integerCoeffs[i];
-                            }
-                            return ss.str();
-                        }());
+        if (recordSteps_) {
+            addBalancingStep("Converting to smallest integer coefficients: " +
+                            [&integerCoeffs]() {
+                                std::stringstream ss;
+                                for (size_t i = 0; i < integerCoeffs.size(); ++i) {
+                                    if (i > 0) ss << ", ";
+                                    ss << integerCoeffs[i];
+                                }
+                                return ss.str();
+                            }());
+        }
         
         // Check for valid coefficients
-        for (int coeff : integerCoeffs) {
+        for (int64_t coeff : integerCoeffs) {
             if (coeff <= 0) {
                 info.result = BalanceResult::NO_SOLUTION;
                 info.message = "Invalid coefficients found (zero or negative)";
@@ -179,7 +469,9 @@ BalanceInfo EquationBalancer::balance(ChemicalEquation& equation) {
         
         if (info.conservationVerified) {
             info.message = "Equation balanced successfully";
-            addBalancingStep("Final balanced equation: " + equation.toString());
+            if (recordSteps_) {
+                addBalancingStep("Final balanced equation: " + equation.toString());
+            }
             addBalancingStep("Atom conservation verified ✓");
         } else {
             info.result = BalanceResult::INVALID_EQUATION;
@@ -196,11 +488,57 @@ BalanceInfo EquationBalancer::balance(ChemicalEquation& equation) {
     return info;
 }
 
+std::vector<BalanceInfo> EquationBalancer::balanceBatch(std::vector<ChemicalEquation>& equations) {
+    // Lane solves record nothing, so stale steps would otherwise survive
+    balancingSteps_.clear();
+    solver_.clearSteps();
+    
+    std::vector<BalanceInfo> results(equations.size());
+    
+    // The lanes are exact, so only the exact mode can share them
+    std::vector<DenseMatrix<int64_t>> systems(equations.size());
+    if (solverMode_ == SolverMode::EXACT_INTEGER) {
+        for (size_t i = 0; i < equations.size(); ++i) {
+            if (!equations[i].isBalanced()) {
+                fillExactMatrix(equations[i], systems[i]);
+            }
+        }
+    }
+    std::vector<std::vector<int64_t>> vectors = batchSolver_.nullVectors(systems);
+    
+    for (size_t i = 0; i < equations.size(); ++i) {
+        const std::vector<int64_t>& coefficients = vectors[i];
+        bool positive = !coefficients.empty() &&
+                        std::all_of(coefficients.begin(), coefficients.end(), [](int64_t value) { return value > 0; });
+        if (!positive) {
+            results[i] = balance(equations[i]);
+            continue;
+        }
+        
+        BalanceInfo& info = results[i];
+        equations[i].setCoefficients(coefficients);
+        info.coefficients = coefficients;
+        info.nullity = 1;
+        info.subReactions.push_back(coefficients);
+        info.conservationVerified = validateAtomConservation(equations[i]);
+        info.atomBalance = getAtomBalance(equations[i]);
+        if (info.conservationVerified) {
+            info.result = BalanceResult::SUCCESS;
+            info.message = "Equation balanced successfully";
+        } else {
+            info.result = BalanceResult::INVALID_EQUATION;
+            info.message = "Balancing failed - atom conservation violated";
+        }
+    }
+    
+    return results;
+}
+
 std::vector<std::string> EquationBalancer::getBalancingSteps() const {
     return balancingSteps_;
 }
 
-std::vector<SolutionStep> EquationBalancer::getMathematicalSteps() const {
+const StepJournal& EquationBalancer::getMathematicalSteps() const {
     return solver_.getSteps();
 }
 
@@ -221,100 +559,234 @@ bool EquationBalancer::validateAtomConservation(const ChemicalEquation& equation
     return true;
 }
 
-std::map<std::string, int> EquationBalancer::getAtomBalance(const ChemicalEquation& equation) {
-    std::map<std::string, int> balance;
+std::map<std::string, int64_t> EquationBalancer::getAtomBalance(const ChemicalEquation& equation) {
+    std::array<int64_t, CompoundDatabase::MAX_ATOMIC_NUMBER + 1> balance{};
     
     // Count atoms from reactants (positive)
     for (const auto& reactant : equation.getReactants()) {
-        auto elements = reactant.first.getElementCount();
-        for (const auto& element : elements) {
-            balance[element.first] += element.second * reactant.second;
+        for (const ElementEntry& element : reactant.first.getElements()) {
+            balance[element.atomicNumber] = checkedAdd(balance[element.atomicNumber],
+                checkedMultiply(element.count, reactant.second));
         }
     }
     
     // Count atoms from products (negative)
     for (const auto& product : equation.getProducts()) {
-        auto elements = product.first.getElementCount();
-        for (const auto& element : elements) {
-            balance[element.first] -= element.second * product.second;
+        for (const ElementEntry& element : product.first.getElements()) {
+            balance[element.atomicNumber] = checkedSubtract(balance[element.atomicNumber],
+                checkedMultiply(element.count, product.second));
         }
     }
     
-    return balance;
+    CompoundDatabase& db = CompoundDatabase::getInstance();
+    std::map<std::string, int64_t> result;
+    for (int atomicNumber : equation.getAllElementIds()) {
+        result[db.getElementSymbol(atomicNumber)] = balance[atomicNumber];
+    }
+    
+    return result;
 }
 
-ChemicalEquation EquationBalancer::parseEquationString(const std::string& equationStr) {
-    ChemicalEquation equation;
-    
-    // Split by arrow
-    std::regex arrowRegex(R"(\s*(?:->|→)\s*)");
-    std::vector<std::string> sides;
-    
-    std::sregex_token_iterator iter(equationStr.begin(), equationStr.end(), arrowRegex, -1);
-    std::sregex_token_iterator end;
-    
-    for (; iter != end; ++iter) {
-        std::string side = *iter;
-        if (!side.empty()) {
-            sides.push_back(side);
+ParseDiagnostic EquationBalancer::parseEquation(std::string_view equationStr, ChemicalEquation& equation) {
+    equation.clear();
+    EquationTokenizer tokenizer(equationStr);
+    bool onProductSide = false;
+    
+    Token token = tokenizer.next();
+    while (token.type != TokenType::END) {
+        if (token.type == TokenType::ARROW) {
+            if (onProductSide) {
+                return {ParseStatus::EXTRA_ARROW, token.position, "Equation has more than one arrow"};
+            }
+            if (equation.getReactants().empty()) {
+                return {ParseStatus::EMPTY_SIDE, token.position, "Equation has no reactants"};
+            }
+            onProductSide = true;
+            token = tokenizer.next();
+            continue;
+        }
+        
+        // Empty terms ("H2 + + O2") are skipped
+        if (token.type == TokenType::PLUS) {
+            token = tokenizer.next();
+            continue;
+        }
+        
+        size_t formulaStart = 0;
+        size_t formulaLength = 0;
+        int coefficient = 1;
+        ParseDiagnostic diagnostic = parseTerm(tokenizer, token, formulaStart, formulaLength, coefficient);
+        if (!diagnostic.ok()) {
+            return diagnostic;
+        }
+        
+        // Repeated species share one parsed compound through the intern table
+        ChemicalCompound compound = FormulaCache::getInstance().intern(
+            equationStr.substr(formulaStart, formulaLength));
+        if (!compound.isValid()) {
+            diagnostic = compound.getParseDiagnostic();
+            diagnostic.position += formulaStart;
+            return diagnostic;
+        }
+        
+        if (onProductSide) {
+            equation.addProduct(compound, coefficient);
+        } else {
+            equation.addReactant(compound, coefficient);
         }
     }
     
-    if (sides.size() != 2) {
-        throw std::invalid_argument("Invalid equation format - must have reactants -> products");
+    if (!onProductSide) {
+        return {ParseStatus::MISSING_ARROW, equationStr.size(), "Equation has no arrow"};
+    }
+    if (equation.getProducts().empty()) {
+        return {ParseStatus::EMPTY_SIDE, equationStr.size(), "Equation has no products"};
     }
     
-    // Parse reactants
-    auto reactants = splitCompounds(sides[0]);
-    for (const std::string& reactantStr : reactants) {
-        auto [formula, coeff] = parseCompoundWithCoefficient(reactantStr);
-        ChemicalCompound compound(formula);
-        if (!compound.isValid()) {
-            throw std::invalid_argument("Invalid reactant: " + formula);
-        }
-        equation.addReactant(compound, coeff);
+    return ParseDiagnostic::success();
+}
+
+ChemicalEquation EquationBalancer::parseEquationString(std::string_view equationStr) {
+    ChemicalEquation equation;
+    
+    ParseDiagnostic diagnostic = parseEquation(equationStr, equation);
+    if (!diagnostic.ok()) {
+        throw std::invalid_argument("Invalid equation: " + diagnostic.toString());
     }
     
-    // Parse products
-    auto products = splitCompounds(sides[1]);
-    for (const std::string& productStr : products) {
-        auto [formula, coeff] = parseCompoundWithCoefficient(productStr);
-        ChemicalCompound compound(formula);
-        if (!compound.isValid()) {
-            throw std::invalid_argument("Invalid product: " + formula);
+    return equation;
+}
+
+BatchParseResult EquationBalancer::parseEquations(const std::vector<std::string>& equationStrs) {
+    BatchParseResult batch;
+    batch.equations.reserve(equationStrs.size());
+    batch.sourceIndices.reserve(equationStrs.size());
+    
+    ChemicalEquation equation;
+    for (size_t index = 0; index < equationStrs.size(); ++index) {
+        ParseDiagnostic diagnostic = parseEquation(equationStrs[index], equation);
+        if (diagnostic.ok()) {
+            batch.equations.push_back(std::move(equation));
+            batch.sourceIndices.push_back(index);
+        } else {
+            batch.errors.push_back({index, diagnostic});
         }
-        equation.addProduct(compound, coeff);
     }
     
-    return equation;
+    return batch;
 }
 
-std::vector<std::string> EquationBalancer::splitCompounds(const std::string& side) {
-    std::vector<std::string> compounds;
+BatchParseResult EquationBalancer::parseEquationLines(std::string_view text) {
+    BatchParseResult batch;
+    ChemicalEquation equation;
+    size_t lineStart = 0;
     
-    std::regex plusRegex(R"(\s*\+\s*)");
-    std::sregex_token_iterator iter(side.begin(), side.end(), plusRegex, -1);
-    std::sregex_token_iterator end;
+    for (size_t line = 0; lineStart < text.size(); ++line) {
+        size_t lineEnd = text.find('\n', lineStart);
+        if (lineEnd == std::string_view::npos) {
+            lineEnd = text.size();
+        }
+        
+        std::string_view lineText = text.substr(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+        
+        // Blank lines are not equations
+        if (lineText.find_first_not_of(" \t\r") == std::string_view::npos) {
+            continue;
+        }
+        
+        ParseDiagnostic diagnostic = parseEquation(lineText, equation);
+        if (diagnostic.ok()) {
+            batch.equations.push_back(std::move(equation));
+            batch.sourceIndices.push_back(line);
+        } else {
+            batch.errors.push_back({line, diagnostic});
+        }
+    }
     
-    for (; iter != end; ++iter) {
-        std::string compound = *iter;
-        if (!compound.empty()) {
-            compounds.push_back(compound);
+    return batch;
+}
+
+std::vector<std::string_view> EquationBalancer::splitCompounds(std::string_view side) {
+    std::vector<std::string_view> compounds;
+    EquationTokenizer tokenizer(side);
+    
+    size_t termStart = std::string_view::npos;
+    size_t termEnd = 0;
+    
+    while (true) {
+        Token token = tokenizer.next();
+        if (token.type == TokenType::PLUS || token.type == TokenType::END) {
+            if (termStart != std::string_view::npos) {
+                compounds.push_back(side.substr(termStart, termEnd - termStart));
+                termStart = std::string_view::npos;
+            }
+            if (token.type == TokenType::END) {
+                break;
+            }
+            continue;
         }
+        
+        if (termStart == std::string_view::npos) {
+            termStart = token.position;
+        }
+        termEnd = token.position + token.text.size();
     }
     
     return compounds;
 }
 
-std::pair<std::string, int> EquationBalancer::parseCompoundWithCoefficient(const std::string& compoundStr) {
-    std::regex coeffRegex(R"(^\s*(\d+)?\s*([A-Za-z0-9()]+)\s*$)");
-    std::smatch match;
+std::pair<std::string_view, int> EquationBalancer::parseCompoundWithCoefficient(std::string_view compoundStr) {
+    EquationTokenizer tokenizer(compoundStr);
+    Token token = tokenizer.next();
+    size_t formulaStart = 0;
+    size_t formulaLength = 0;
+    int coefficient = 1;
+    
+    ParseDiagnostic diagnostic = parseTerm(tokenizer, token, formulaStart, formulaLength, coefficient);
+    if (!diagnostic.ok() || token.type != TokenType::END) {
+        throw std::invalid_argument("Invalid compound format: " + std::string(compoundStr));
+    }
     
-    if (std::regex_match(compoundStr, match, coeffRegex)) {
-        int coefficient = match[1].str().empty() ? 1 : std::stoi(match[1].str());
-        std::string formula = match[2].str();
-        return {formula, coefficient};
+    return {compoundStr.substr(formulaStart, formulaLength), coefficient};
+}
+
+std::string EquationBalancer::formatSubReaction(const ChemicalEquation& equation, const std::vector<int64_t>& coefficients) {
+    return formatSubReaction(equation, std::vector<BigInteger>(coefficients.begin(), coefficients.end()));
+}
+
+std::string EquationBalancer::formatSubReaction(const ChemicalEquation& equation, const std::vector<BigInteger>& coefficients) {
+    const auto& reactants = equation.getReactants();
+    const auto& products = equation.getProducts();
+    
+    std::vector<std::string> left;
+    std::vector<std::string> right;
+    for (size_t i = 0; i < coefficients.size() && i < reactants.size() + products.size(); ++i) {
+        const BigInteger& coefficient = coefficients[i];
+        if (coefficient.isZero()) {
+            continue;
+        }
+        
+        bool isReactant = i < reactants.size();
+        const ChemicalCompound& compound = isReactant ? reactants[i].first : products[i - reactants.size()].first;
+        std::string magnitude = coefficient.abs().toString();
+        std::string term = (magnitude != "1" ? magnitude : "") + compound.getFormula();
+        
+        if ((coefficient.sign() > 0) == isReactant) {
+            left.push_back(term);
+        } else {
+            right.push_back(term);
+        }
     }
     
-    throw std::invalid_argument("Invalid compound format: " + compoundStr);
+    auto join = [](const std::vector<std::string>& terms) {
+        std::string result;
+        for (size_t i = 0; i < terms.size(); ++i) {
+            if (i > 0) result += " + ";
+            result += terms[i];
+        }
+        return result;
+    };
+    
+    return join(left) + " → " + join(right);
 }
\ No newline at end of file
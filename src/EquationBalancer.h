@@ -3,9 +3,18 @@
 
 #include "ChemicalCompound.h"
 #include "MatrixSolver.h"
+#include "BigInteger.h"
+#include "MultiModularSolver.h"
+#include "SmallMatrixSolver.h"
+#include "BatchSolver.h"
+#include "LatticeSolver.h"
+#include "MixedPrecisionSolver.h"
+#include "EquationTokenizer.h"
 #include <vector>
 #include <string>
+#include <string_view>
 #include <map>
+#include <limits>
 
 enum class BalanceResult {
     SUCCESS,
@@ -13,41 +22,174 @@ enum class BalanceResult {
     NO_SOLUTION,
     INFINITE_SOLUTIONS,
     INVALID_EQUATION,
-    PARSING_ERROR
+    PARSING_ERROR,
+    COEFFICIENT_OVERFLOW // the coefficients do not fit in 64 bits, see BalanceInfo::largeCoefficients
 };
 
 struct BalanceInfo {
     BalanceResult result;
-    std::vector<int> coefficients;
+    // With INFINITE_SOLUTIONS, the combination with the smallest coefficient
+    // sum that keeps every species on its side, or empty if none was found
+    std::vector<int64_t> coefficients;
     std::string message;
-    std::map<std::string, int> atomBalance;
+    std::map<std::string, int64_t> atomBalance;
     bool conservationVerified;
+    size_t nullity; // dimension of the solution space, 0 when the solver did not run
+    // Independent balanced reactions spanning the solution space, one
+    // coefficient per species in equation order; a negative coefficient
+    // moves that species to the other side
+    std::vector<std::vector<int64_t>> subReactions;
+    // When the exact solution has a coefficient beyond 64 bits, its basis
+    // is kept here instead of in subReactions and the equation is left as
+    // it was. With COEFFICIENT_OVERFLOW, largeCoefficients holds the
+    // unique balanced coefficients, or stays empty when the floating-point
+    // path overflowed and never had them exactly.
+    std::vector<std::vector<BigInteger>> largeSubReactions;
+    std::vector<BigInteger> largeCoefficients;
+};
+
+struct EquationDiagnostic {
+    size_t index; // position of the rejected equation in the batch input
+    ParseDiagnostic diagnostic;
+};
+
+struct BatchParseResult {
+    std::vector<ChemicalEquation> equations; // successfully parsed, in input order
+    std::vector<size_t> sourceIndices;       // input index of each parsed equation
+    std::vector<EquationDiagnostic> errors;
 };
 
 class EquationBalancer {
 private:
     MatrixSolver solver_;
+    MultiModularSolver modularSolver_; // exact fallback when 64-bit elimination overflows
+    SmallMatrixSolver<6, 8> smallSolver_; // up to 6 elements and 8 species, when no steps are recorded
+    SolverMode solverMode_;
+    bool recordSteps_;
+    bool smallSolverEnabled_;
+    BatchSolver batchSolver_; // used by balanceBatch
+    LatticeSolver latticeSolver_; // smallest positive combination when the solution is not unique
+    MixedPrecisionSolver mixedSolver_; // first attempt in MIXED_PRECISION mode
     std::vector<std::string> balancingSteps_;
+    DenseMatrix<double> precheckMatrix_; // reused by solutionDimension
     
-    std::vector<std::vector<double>> buildStoichiometricMatrix(const ChemicalEquation& equation);
+    DenseMatrix<double> buildStoichiometricMatrix(const ChemicalEquation& equation);
+    static void fillStoichiometricMatrix(const ChemicalEquation& equation, const std::vector<std::string>& elements,
+                                         DenseMatrix<double>& matrix);
+    // Same matrix with rows in atomic number order
+    static void fillExactMatrix(const ChemicalEquation& equation, DenseMatrix<int64_t>& matrix);
+    // Exact basis from smallSolver_, filled straight from the compounds;
+    // false when the equation does not fit or the solve overflows
+    bool solveSmall(const ChemicalEquation& equation, std::vector<std::vector<int64_t>>& basis);
     void addBalancingStep(const std::string& step);
-    std::string formatMatrix(const std::vector<std::vector<double>>& matrix, const std::vector<std::string>& elements, const ChemicalEquation& equation);
+    std::string formatMatrix(const DenseMatrix<double>& matrix, const std::vector<std::string>& elements, const ChemicalEquation& equation);
     
 public:
+    // Exact integer elimination by default; falls back to floating point when
+    // an intermediate value overflows 64 bits
+    explicit EquationBalancer(SolverMode mode = SolverMode::EXACT_INTEGER);
+    
+    void setSolverMode(SolverMode mode);
+    SolverMode getSolverMode() const;
+    
+    // Off: balance() records neither text steps nor matrix snapshots, for
+    // callers that only want the coefficients
+    void setRecordSteps(bool record);
+    bool isRecordingSteps() const;
+    
+    // On by default: exact solves of equations that fit smallSolver_ skip
+    // the generic MatrixSolver while steps are off
+    void setSmallSolverEnabled(bool enabled);
+    bool isSmallSolverEnabled() const;
+    
+    // Branch-and-bound nodes spent looking for the smallest positive
+    // combination of a multi-dimensional solution space; 0 skips the search
+    // and leaves BalanceInfo::coefficients empty
+    void setMinimalSearchBudget(size_t nodes);
+    size_t getMinimalSearchBudget() const;
+    
     BalanceInfo balance(ChemicalEquation& equation);
+    
+    // Balances every equation, with the same results as calling balance()
+    // on each. Unique solutions are found together by batchSolver_; the
+    // equations it leaves, and any already balanced, go through balance().
+    // Steps are cleared first; afterwards they describe only the last
+    // equation that went through balance(), if any did.
+    std::vector<BalanceInfo> balanceBatch(std::vector<ChemicalEquation>& equations);
+    
+    // Dimension of the solution space from a floating-point rank check:
+    // 1 when balance() will find a unique answer, 0 when it finds none and
+    // more when it will report INFINITE_SOLUTIONS. Records no steps.
+    int solutionDimension(const ChemicalEquation& equation);
     std::vector<std::string> getBalancingSteps() const;
-    std::vector<SolutionStep> getMathematicalSteps() const;
+    const StepJournal& getMathematicalSteps() const;
     
     void clearSteps();
     
     // Validation methods
     bool validateAtomConservation(const ChemicalEquation& equation);
-    std::map<std::string, int> getAtomBalance(const ChemicalEquation& equation);
+    std::map<std::string, int64_t> getAtomBalance(const ChemicalEquation& equation);
     
     // Static helper methods
-    static ChemicalEquation parseEquationString(const std::string& equationStr);
-    static std::vector<std::string> splitCompounds(const std::string& side);
-    static std::pair<std::string, int> parseCompoundWithCoefficient(const std::string& compoundStr);
+    static ChemicalEquation parseEquationString(std::string_view equationStr);
+    
+    // Exception-free parsing: no throwing and no logging, errors are returned
+    static ParseDiagnostic parseEquation(std::string_view equationStr, ChemicalEquation& equation);
+    static BatchParseResult parseEquations(const std::vector<std::string>& equationStrs);
+    // One equation per line, read in place from a caller-owned buffer such as
+    // a memory-mapped file; indices in the result are line numbers (0-based)
+    static BatchParseResult parseEquationLines(std::string_view text);
+    // Returned views point into the argument's buffer
+    static std::vector<std::string_view> splitCompounds(std::string_view side);
+    static std::pair<std::string_view, int> parseCompoundWithCoefficient(std::string_view compoundStr);
+    
+    // Writes one of BalanceInfo::subReactions as an equation over the species
+    // of the given equation, e.g. "2H2 + O2 → 2H2O"
+    static std::string formatSubReaction(const ChemicalEquation& equation, const std::vector<int64_t>& coefficients);
+    static std::string formatSubReaction(const ChemicalEquation& equation, const std::vector<BigInteger>& coefficients);
+    
+    // Parses "[coefficient] formula [state]" starting at token and leaves token
+    // on whatever follows the term. Shared by parseEquation, the GUI term
+    // cache and the compile-time EquationLiteral.
+    static constexpr ParseDiagnostic parseTerm(EquationTokenizer& tokenizer, Token& token,
+                                               size_t& formulaStart, size_t& formulaLength, int& coefficient);
 };
 
+constexpr ParseDiagnostic EquationBalancer::parseTerm(EquationTokenizer& tokenizer, Token& token,
+                                                      size_t& formulaStart, size_t& formulaLength, int& coefficient) {
+    coefficient = 1;
+    if (token.type == TokenType::COEFFICIENT) {
+        int64_t value = 0;
+        for (char digit : token.text) {
+            value = value * 10 + (digit - '0');
+            if (value > std::numeric_limits<int>::max()) {
+                return {ParseStatus::COEFFICIENT_OVERFLOW, token.position, "Coefficient too large"};
+            }
+        }
+        coefficient = static_cast<int>(value);
+        token = tokenizer.next();
+    }
+    
+    if (token.type != TokenType::FORMULA) {
+        return {ParseStatus::INVALID_TERM, token.position, "Expected a formula"};
+    }
+    
+    // The state suffix stays part of the formula text, as in "Fe(s)"
+    formulaStart = token.position;
+    size_t formulaEnd = token.position + token.text.size();
+    token = tokenizer.next();
+    
+    if (token.type == TokenType::STATE) {
+        formulaEnd = token.position + token.text.size();
+        token = tokenizer.next();
+    }
+    
+    if (token.type != TokenType::PLUS && token.type != TokenType::ARROW && token.type != TokenType::END) {
+        return {ParseStatus::INVALID_TERM, token.position, "Unexpected text after formula"};
+    }
+    
+    formulaLength = formulaEnd - formulaStart;
+    return ParseDiagnostic::success();
+}
+
 #endif // EQUATION_BALANCER_H
\ No newline at end of file
@@ -0,0 +1,358 @@
+#ifndef EQUATION_LITERAL_H
+#define EQUATION_LITERAL_H
+
+#include "EquationBalancer.h"
+#include "FormulaLiteral.h"
+#include <array>
+#include <string_view>
+#include <cstdint>
+#include <limits>
+
+// An equation parsed at compile time into its stoichiometric matrix:
+//
+//     constexpr auto combustion = balance("C3H8 + O2 -> CO2 + H2O"_eq);
+//     static_assert(combustion.ok() && combustion[1] == 5);
+//
+// Terms are read with the runtime tokenizer and term grammar, and each
+// formula with FormulaLiteral, so diagnostics match parseEquation.
+class EquationLiteral {
+public:
+    static constexpr size_t MAX_TERMS = 16;
+    static constexpr size_t MAX_ELEMENTS = 16;
+
+    using Row = std::array<int64_t, MAX_TERMS>;
+    using Matrix = std::array<Row, MAX_ELEMENTS>;
+
+private:
+    std::string_view equation_;
+    std::array<std::string_view, MAX_TERMS> formulas_;
+    std::array<int, MAX_TERMS> coefficients_;
+    std::array<int, MAX_ELEMENTS> elementIds_;
+    Matrix matrix_; // one row per element, product columns negated
+    size_t termCount_;
+    size_t reactantCount_;
+    size_t elementCount_;
+    ParseDiagnostic diagnostic_;
+
+    constexpr ParseDiagnostic addTerm(size_t formulaStart, size_t formulaLength, int coefficient, bool product) {
+        if (termCount_ == MAX_TERMS) {
+            return {ParseStatus::TOO_MANY_TERMS, formulaStart, "Too many terms for an equation literal"};
+        }
+
+        std::string_view formula = equation_.substr(formulaStart, formulaLength);
+        FormulaLiteral compound(formula);
+        if (!compound.ok()) {
+            ParseDiagnostic diagnostic = compound.diagnostic();
+            diagnostic.position += formulaStart;
+            return diagnostic;
+        }
+
+        size_t column = termCount_++;
+        formulas_[column] = formula;
+        coefficients_[column] = coefficient;
+
+        for (int atomicNumber = 1; atomicNumber <= CompoundDatabase::MAX_ATOMIC_NUMBER; ++atomicNumber) {
+            if (!compound.contains(atomicNumber)) {
+                continue;
+            }
+
+            size_t row = 0;
+            while (row < elementCount_ && elementIds_[row] != atomicNumber) {
+                ++row;
+            }
+            if (row == elementCount_) {
+                if (elementCount_ == MAX_ELEMENTS) {
+                    return {ParseStatus::TOO_MANY_ELEMENTS, formulaStart, "Too many elements for an equation literal"};
+                }
+                elementIds_[elementCount_++] = atomicNumber;
+            }
+
+            int64_t count = compound.count(atomicNumber);
+            matrix_[row][column] = product ? -count : count;
+        }
+
+        return ParseDiagnostic::success();
+    }
+
+    // Same structure as EquationBalancer::parseEquation
+    constexpr ParseDiagnostic parse() {
+        EquationTokenizer tokenizer(equation_);
+        bool onProductSide = false;
+
+        Token token = tokenizer.next();
+        while (token.type != TokenType::END) {
+            if (token.type == TokenType::ARROW) {
+                if (onProductSide) {
+                    return {ParseStatus::EXTRA_ARROW, token.position, "Equation has more than one arrow"};
+                }
+                if (termCount_ == 0) {
+                    return {ParseStatus::EMPTY_SIDE, token.position, "Equation has no reactants"};
+                }
+                onProductSide = true;
+                reactantCount_ = termCount_;
+                token = tokenizer.next();
+                continue;
+            }
+
+            if (token.type == TokenType::PLUS) {
+                token = tokenizer.next();
+                continue;
+            }
+
+            size_t formulaStart = 0;
+            size_t formulaLength = 0;
+            int coefficient = 1;
+            ParseDiagnostic diagnostic = EquationBalancer::parseTerm(tokenizer, token, formulaStart, formulaLength, coefficient);
+            if (!diagnostic.ok()) {
+                return diagnostic;
+            }
+
+            diagnostic = addTerm(formulaStart, formulaLength, coefficient, onProductSide);
+            if (!diagnostic.ok()) {
+                return diagnostic;
+            }
+        }
+
+        if (!onProductSide) {
+            return {ParseStatus::MISSING_ARROW, equation_.size(), "Equation has no arrow"};
+        }
+        if (termCount_ == reactantCount_) {
+            return {ParseStatus::EMPTY_SIDE, equation_.size(), "Equation has no products"};
+        }
+
+        return ParseDiagnostic::success();
+    }
+
+public:
+    constexpr explicit EquationLiteral(std::string_view equation)
+        : equation_(equation), formulas_{}, coefficients_{}, elementIds_{}, matrix_{},
+          termCount_(0), reactantCount_(0), elementCount_(0), diagnostic_(ParseDiagnostic::success()) {
+        diagnostic_ = parse();
+    }
+
+    constexpr std::string_view equation() const { return equation_; }
+    constexpr bool ok() const { return diagnostic_.ok(); }
+    constexpr const ParseDiagnostic& diagnostic() const { return diagnostic_; }
+
+    // Terms are numbered reactants first, in input order
+    constexpr size_t termCount() const { return termCount_; }
+    constexpr size_t reactantCount() const { return reactantCount_; }
+    constexpr size_t productCount() const { return termCount_ - reactantCount_; }
+    constexpr std::string_view formula(size_t term) const { return formulas_[term]; }
+    constexpr int coefficient(size_t term) const { return coefficients_[term]; }
+
+    // Rows of the stoichiometric matrix, in order of first appearance
+    constexpr size_t elementCount() const { return elementCount_; }
+    constexpr int atomicNumber(size_t row) const { return elementIds_[row]; }
+    constexpr const Matrix& matrix() const { return matrix_; }
+};
+
+constexpr EquationLiteral operator""_eq(const char* text, size_t length) {
+    return EquationLiteral(std::string_view(text, length));
+}
+
+// Coefficients of a compile-time balance, one per term
+struct LiteralBalance {
+    BalanceResult result;
+    std::array<int64_t, EquationLiteral::MAX_TERMS> coefficients;
+    size_t size;
+
+    constexpr bool ok() const { return result == BalanceResult::SUCCESS; }
+    constexpr int64_t operator[](size_t term) const { return coefficients[term]; }
+};
+
+// Exact integer counterpart of MatrixSolver::gaussianElimination followed by
+// reduceToIntegers, usable in constant expressions
+class LiteralSolver {
+private:
+    static constexpr bool multiply(int64_t a, int64_t b, int64_t& result) {
+        uint64_t magnitudeA = a < 0 ? 0 - static_cast<uint64_t>(a) : static_cast<uint64_t>(a);
+        uint64_t magnitudeB = b < 0 ? 0 - static_cast<uint64_t>(b) : static_cast<uint64_t>(b);
+        if (magnitudeA != 0 && magnitudeB > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) / magnitudeA) {
+            return false;
+        }
+        result = a * b;
+        return true;
+    }
+
+    static constexpr bool subtract(int64_t a, int64_t b, int64_t& result) {
+        if ((b > 0 && a < std::numeric_limits<int64_t>::min() + b) ||
+            (b < 0 && a > std::numeric_limits<int64_t>::max() + b)) {
+            return false;
+        }
+        result = a - b;
+        return true;
+    }
+
+    static constexpr int64_t gcd(int64_t a, int64_t b) {
+        a = a < 0 ? -a : a;
+        b = b < 0 ? -b : b;
+        while (b != 0) {
+            int64_t temp = b;
+            b = a % b;
+            a = temp;
+        }
+        return a;
+    }
+
+    static constexpr void reduceRow(EquationLiteral::Row& row, size_t cols) {
+        int64_t content = 0;
+        for (size_t col = 0; col < cols; ++col) {
+            content = gcd(content, row[col]);
+        }
+        if (content > 1) {
+            for (size_t col = 0; col < cols; ++col) {
+                row[col] /= content;
+            }
+        }
+    }
+
+    // row = scale * row - factor * source, false on overflow
+    static constexpr bool combineRows(EquationLiteral::Row& row, const EquationLiteral::Row& source,
+                                      int64_t scale, int64_t factor, size_t cols) {
+        for (size_t col = 0; col < cols; ++col) {
+            int64_t scaled = 0;
+            int64_t subtracted = 0;
+            if (!multiply(scale, row[col], scaled) || !multiply(factor, source[col], subtracted) ||
+                !subtract(scaled, subtracted, row[col])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    static constexpr LiteralBalance solve(const EquationLiteral& equation) {
+        LiteralBalance balance = {BalanceResult::PARSING_ERROR, {}, equation.termCount()};
+        if (!equation.ok()) {
+            return balance;
+        }
+
+        // COEFFICIENT_OVERFLOW reports coefficients too large for 64-bit arithmetic, as balance() does
+        EquationLiteral::Matrix matrix = equation.matrix();
+        size_t rows = equation.elementCount();
+        size_t cols = equation.termCount();
+        std::array<size_t, EquationLiteral::MAX_ELEMENTS> pivotColumns{};
+        size_t rank = 0;
+
+        // Forward elimination, fraction-free (Bareiss): every division by the
+        // previous pivot is exact, so entries stay integers of minor size
+        int64_t previousPivot = 1;
+        for (size_t col = 0; col < cols && rank < rows; ++col) {
+            size_t pivotRow = rank;
+            while (pivotRow < rows && matrix[pivotRow][col] == 0) {
+                ++pivotRow;
+            }
+            if (pivotRow == rows) {
+                continue;
+            }
+            if (pivotRow != rank) {
+                EquationLiteral::Row temp = matrix[pivotRow];
+                matrix[pivotRow] = matrix[rank];
+                matrix[rank] = temp;
+            }
+
+            int64_t pivot = matrix[rank][col];
+            for (size_t row = rank + 1; row < rows; ++row) {
+                int64_t factor = matrix[row][col];
+                for (size_t j = col + 1; j < cols; ++j) {
+                    int64_t scaled = 0;
+                    int64_t subtracted = 0;
+                    int64_t value = 0;
+                    if (!multiply(pivot, matrix[row][j], scaled) || !multiply(factor, matrix[rank][j], subtracted) ||
+                        !subtract(scaled, subtracted, value) || value % previousPivot != 0) {
+                        balance.result = BalanceResult::COEFFICIENT_OVERFLOW;
+                        return balance;
+                    }
+                    matrix[row][j] = value / previousPivot;
+                }
+                matrix[row][col] = 0;
+            }
+
+            previousPivot = pivot;
+            pivotColumns[rank++] = col;
+        }
+
+        if (rank == cols) {
+            balance.result = BalanceResult::NO_SOLUTION;
+            return balance;
+        }
+        if (cols - rank > 1) {
+            balance.result = BalanceResult::INFINITE_SOLUTIONS;
+            return balance;
+        }
+
+        size_t freeColumn = 0;
+        for (size_t k = 0; k < rank && pivotColumns[k] == freeColumn; ++k) {
+            ++freeColumn;
+        }
+
+        // Back elimination to reduced form, keeping each row primitive
+        for (size_t k = rank; k-- > 0;) {
+            reduceRow(matrix[k], cols);
+            for (size_t row = 0; row < k; ++row) {
+                int64_t factor = matrix[row][pivotColumns[k]];
+                if (factor == 0) {
+                    continue;
+                }
+                if (!combineRows(matrix[row], matrix[k], matrix[k][pivotColumns[k]], factor, cols)) {
+                    balance.result = BalanceResult::COEFFICIENT_OVERFLOW;
+                    return balance;
+                }
+                reduceRow(matrix[row], cols);
+            }
+        }
+
+        // Row k now reads pivot * x[pivotColumn] + a * x[free] = 0; the free
+        // value is the smallest one that makes every pivot variable integral
+        int64_t freeValue = 1;
+        for (size_t k = 0; k < rank; ++k) {
+            int64_t pivot = matrix[k][pivotColumns[k]];
+            int64_t needed = pivot / gcd(pivot, matrix[k][freeColumn]);
+            needed = needed < 0 ? -needed : needed;
+            if (!multiply(freeValue / gcd(freeValue, needed), needed, freeValue)) {
+                balance.result = BalanceResult::COEFFICIENT_OVERFLOW;
+                return balance;
+            }
+        }
+
+        balance.coefficients[freeColumn] = freeValue;
+        for (size_t k = 0; k < rank; ++k) {
+            int64_t pivot = matrix[k][pivotColumns[k]];
+            int64_t common = gcd(pivot, matrix[k][freeColumn]);
+            if (!multiply(-(matrix[k][freeColumn] / common), freeValue / (pivot / common),
+                          balance.coefficients[pivotColumns[k]])) {
+                balance.result = BalanceResult::COEFFICIENT_OVERFLOW;
+                return balance;
+            }
+        }
+
+        // Smallest integers, all positive
+        int64_t divisor = 0;
+        bool allNonPositive = true;
+        for (size_t term = 0; term < cols; ++term) {
+            divisor = gcd(divisor, balance.coefficients[term]);
+            allNonPositive = allNonPositive && balance.coefficients[term] <= 0;
+        }
+        for (size_t term = 0; term < cols; ++term) {
+            balance.coefficients[term] /= divisor;
+            if (allNonPositive) {
+                balance.coefficients[term] = -balance.coefficients[term];
+            }
+        }
+
+        balance.result = BalanceResult::SUCCESS;
+        for (size_t term = 0; term < cols; ++term) {
+            if (balance.coefficients[term] <= 0) {
+                balance.result = BalanceResult::NO_SOLUTION;
+            }
+        }
+        return balance;
+    }
+};
+
+constexpr LiteralBalance balance(const EquationLiteral& equation) {
+    return LiteralSolver::solve(equation);
+}
+
+#endif // EQUATION_LITERAL_H
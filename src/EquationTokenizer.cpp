@@ -0,0 +1,34 @@
+#include "EquationTokenizer.h"
+
+std::vector<Token> EquationTokenizer::tokenize(std::string_view input) {
+    std::vector<Token> tokens;
+    EquationTokenizer tokenizer(input);
+
+    while (true) {
+        Token token = tokenizer.next();
+        tokens.push_back(token);
+        if (token.type == TokenType::END) {
+            break;
+        }
+    }
+
+    return tokens;
+}
+
+std::string EquationTokenizer::cleanFormula(std::string_view formula) {
+    std::string clean;
+    clean.reserve(formula.size());
+
+    size_t pos = 0;
+    while (pos < formula.size()) {
+        if (isWhitespace(formula[pos])) {
+            ++pos;
+        } else if (size_t stateLength = stateLengthAt(formula, pos)) {
+            pos += stateLength;
+        } else {
+            clean += formula[pos++];
+        }
+    }
+
+    return clean;
+}
@@ -0,0 +1,145 @@
+#ifndef EQUATION_TOKENIZER_H
+#define EQUATION_TOKENIZER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class TokenType {
+    FORMULA,        // H2O, Ca(OH)2
+    COEFFICIENT,    // leading integer of a term
+    STATE,          // (s), (l), (g), (aq)
+    PLUS,           // +
+    ARROW,          // -> or →
+    END,
+    INVALID
+};
+
+struct Token {
+    TokenType type;
+    size_t position;
+    std::string_view text; // points into the tokenizer input
+};
+
+// Hand-written single-pass scanner for equation strings. Replaces the
+// per-call std::regex objects previously used for splitting sides, terms,
+// coefficients and state suffixes. Everything except the allocating helpers
+// is constexpr, so compile-time equation literals tokenize exactly like the
+// runtime parser.
+class EquationTokenizer {
+private:
+    std::string_view input_;
+    size_t pos_;
+
+    constexpr void skipWhitespace() {
+        while (pos_ < input_.size() && isWhitespace(input_[pos_])) {
+            ++pos_;
+        }
+    }
+
+public:
+    constexpr explicit EquationTokenizer(std::string_view input) : input_(input), pos_(0) {}
+
+    constexpr Token next();
+    constexpr size_t position() const { return pos_; }
+
+    static std::vector<Token> tokenize(std::string_view input);
+
+    // Formula text with whitespace and state suffixes removed, in one pass
+    static std::string cleanFormula(std::string_view formula);
+
+    // Length of a "(s)"-style suffix starting at 'at' / ending before 'end', 0 if none
+    static constexpr size_t stateLengthAt(std::string_view text, size_t at);
+    static constexpr size_t stateLengthBefore(std::string_view text, size_t end);
+
+    static constexpr bool isWhitespace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    static constexpr bool isFormulaChar(char c) {
+        return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
+               (c >= '0' && c <= '9') || c == '(' || c == ')';
+    }
+};
+
+constexpr size_t EquationTokenizer::stateLengthAt(std::string_view text, size_t at) {
+    // States are lowercase inside parentheses, groups always start uppercase
+    if (at + 2 >= text.size() || text[at] != '(') {
+        return 0;
+    }
+
+    char c = text[at + 1];
+    if ((c == 's' || c == 'l' || c == 'g') && text[at + 2] == ')') {
+        return 3;
+    }
+    if (c == 'a' && at + 3 < text.size() && text[at + 2] == 'q' && text[at + 3] == ')') {
+        return 4;
+    }
+    return 0;
+}
+
+constexpr size_t EquationTokenizer::stateLengthBefore(std::string_view text, size_t end) {
+    if (end >= 3 && stateLengthAt(text, end - 3) == 3) {
+        return 3;
+    }
+    if (end >= 4 && stateLengthAt(text, end - 4) == 4) {
+        return 4;
+    }
+    return 0;
+}
+
+constexpr Token EquationTokenizer::next() {
+    skipWhitespace();
+
+    size_t start = pos_;
+    if (pos_ >= input_.size()) {
+        return {TokenType::END, start, input_.substr(start, 0)};
+    }
+
+    char c = input_[pos_];
+
+    if (c == '+') {
+        ++pos_;
+        return {TokenType::PLUS, start, input_.substr(start, 1)};
+    }
+
+    if (c == '-' && pos_ + 1 < input_.size() && input_[pos_ + 1] == '>') {
+        pos_ += 2;
+        return {TokenType::ARROW, start, input_.substr(start, 2)};
+    }
+
+    // UTF-8 encoding of U+2192 (→)
+    if (c == '\xE2' && input_.compare(pos_, 3, "\xE2\x86\x92") == 0) {
+        pos_ += 3;
+        return {TokenType::ARROW, start, input_.substr(start, 3)};
+    }
+
+    // A digit can only start a token at the beginning of a term,
+    // digits inside a formula are consumed by the formula itself
+    if (c >= '0' && c <= '9') {
+        while (pos_ < input_.size() && input_[pos_] >= '0' && input_[pos_] <= '9') {
+            ++pos_;
+        }
+        return {TokenType::COEFFICIENT, start, input_.substr(start, pos_ - start)};
+    }
+
+    if (size_t stateLength = stateLengthAt(input_, pos_)) {
+        pos_ += stateLength;
+        return {TokenType::STATE, start, input_.substr(start, stateLength)};
+    }
+
+    if ((c >= 'A' && c <= 'Z') || c == '(') {
+        while (pos_ < input_.size() && isFormulaChar(input_[pos_])) {
+            if (input_[pos_] == '(' && stateLengthAt(input_, pos_)) {
+                break;
+            }
+            ++pos_;
+        }
+        return {TokenType::FORMULA, start, input_.substr(start, pos_ - start)};
+    }
+
+    ++pos_;
+    return {TokenType::INVALID, start, input_.substr(start, 1)};
+}
+
+#endif // EQUATION_TOKENIZER_H
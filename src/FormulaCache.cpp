@@ -0,0 +1,133 @@
+#include "FormulaCache.h"
+#include <functional>
+
+FormulaCache* FormulaCache::instance_ = nullptr;
+
+FormulaCache::FormulaCache()
+    : shardCapacity_((DEFAULT_CAPACITY + SHARD_COUNT - 1) / SHARD_COUNT) {}
+
+FormulaCache& FormulaCache::getInstance() {
+    static std::once_flag initialized;
+    std::call_once(initialized, []() { instance_ = new FormulaCache(); });
+    return *instance_;
+}
+
+FormulaCache::Shard& FormulaCache::shardFor(std::string_view formula) {
+    return shards_[std::hash<std::string_view>()(formula) % SHARD_COUNT];
+}
+
+ChemicalCompound FormulaCache::intern(std::string_view formula) {
+    if (formula.size() > MAX_FORMULA_LENGTH) {
+        return ChemicalCompound(formula);
+    }
+    
+    Shard& shard = shardFor(formula);
+    
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.entries.find(formula);
+        if (it != shard.entries.end()) {
+            it->second->referenced.store(true, std::memory_order_relaxed);
+            shard.hits.fetch_add(1, std::memory_order_relaxed);
+            return it->second->compound;
+        }
+    }
+    
+    // Parse outside the lock; if another thread wins the race its entry is kept
+    ChemicalCompound compound(formula);
+    
+    // Invalid text is parsed on every call rather than evicting real formulas
+    if (!compound.isValid()) {
+        shard.misses.fetch_add(1, std::memory_order_relaxed);
+        return compound;
+    }
+    
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.entries.find(formula);
+    if (it != shard.entries.end()) {
+        shard.hits.fetch_add(1, std::memory_order_relaxed);
+        return it->second->compound;
+    }
+    
+    shard.misses.fetch_add(1, std::memory_order_relaxed);
+    insert(shard, compound);
+    return compound;
+}
+
+void FormulaCache::insert(Shard& shard, const ChemicalCompound& compound) {
+    auto entry = std::make_unique<Entry>(compound);
+    std::string_view key = entry->compound.data_->formula;
+    size_t capacity = shardCapacity_.load(std::memory_order_relaxed);
+    
+    if (capacity == 0) {
+        return;
+    }
+    
+    if (shard.clock.size() < capacity) {
+        shard.clock.push_back(key);
+        shard.entries.emplace(key, std::move(entry));
+        return;
+    }
+    
+    // Sweep the clock hand, giving referenced entries a second chance
+    while (true) {
+        if (shard.hand >= shard.clock.size()) {
+            shard.hand = 0;
+        }
+        
+        auto victim = shard.entries.find(shard.clock[shard.hand]);
+        if (victim->second->referenced.exchange(false, std::memory_order_relaxed)) {
+            ++shard.hand;
+            continue;
+        }
+        
+        shard.entries.erase(victim);
+        shard.evictions.fetch_add(1, std::memory_order_relaxed);
+        shard.clock[shard.hand++] = key;
+        shard.entries.emplace(key, std::move(entry));
+        return;
+    }
+}
+
+FormulaCacheStats FormulaCache::getStats() const {
+    FormulaCacheStats stats = {0, 0, 0, 0, shardCapacity_.load(std::memory_order_relaxed) * SHARD_COUNT};
+    
+    for (const Shard& shard : shards_) {
+        stats.hits += shard.hits.load(std::memory_order_relaxed);
+        stats.misses += shard.misses.load(std::memory_order_relaxed);
+        stats.evictions += shard.evictions.load(std::memory_order_relaxed);
+        
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        stats.size += shard.entries.size();
+    }
+    
+    return stats;
+}
+
+void FormulaCache::setCapacity(size_t capacity) {
+    size_t shardCapacity = (capacity + SHARD_COUNT - 1) / SHARD_COUNT;
+    shardCapacity_.store(shardCapacity, std::memory_order_relaxed);
+    
+    // Trim shards that are now over capacity
+    for (Shard& shard : shards_) {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        while (shard.clock.size() > shardCapacity) {
+            shard.entries.erase(shard.clock.back());
+            shard.clock.pop_back();
+            shard.evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+        shard.hand = 0;
+    }
+}
+
+void FormulaCache::clear() {
+    for (Shard& shard : shards_) {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.entries.clear();
+        shard.clock.clear();
+        shard.hand = 0;
+        shard.hits.store(0, std::memory_order_relaxed);
+        shard.misses.store(0, std::memory_order_relaxed);
+        shard.evictions.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef FORMULA_CACHE_H
+#define FORMULA_CACHE_H
+
+#include "ChemicalCompound.h"
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <cstdint>
+
+struct FormulaCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    size_t size;
+    size_t capacity;
+};
+
+// Process-wide intern table mapping formula text to one shared, immutable
+// ChemicalCompound. Lookups take a shared lock on one of several shards;
+// when a shard is full the CLOCK (second chance) policy picks the entry to
+// evict. Evicted compounds stay valid for as long as callers hold them.
+class FormulaCache {
+private:
+    static constexpr size_t SHARD_COUNT = 16;
+    static constexpr size_t DEFAULT_CAPACITY = 65536;
+    static constexpr size_t MAX_FORMULA_LENGTH = 256; // longer formulas bypass the cache
+    
+    struct Entry {
+        ChemicalCompound compound;
+        std::atomic<bool> referenced;
+        
+        explicit Entry(const ChemicalCompound& c) : compound(c), referenced(true) {}
+    };
+    
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        // Keys view the formula stored inside each entry's compound
+        std::unordered_map<std::string_view, std::unique_ptr<Entry>> entries;
+        std::vector<std::string_view> clock;
+        size_t hand = 0;
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> misses{0};
+        std::atomic<uint64_t> evictions{0};
+    };
+    
+    Shard shards_[SHARD_COUNT];
+    std::atomic<size_t> shardCapacity_;
+    static FormulaCache* instance_;
+    
+    FormulaCache();
+    Shard& shardFor(std::string_view formula);
+    void insert(Shard& shard, const ChemicalCompound& compound);
+    
+public:
+    static FormulaCache& getInstance();
+    
+    // Returns the shared compound for formula, parsing it on first use.
+    // Formulas that fail to parse are returned without being cached.
+    ChemicalCompound intern(std::string_view formula);
+    
+    FormulaCacheStats getStats() const;
+    void setCapacity(size_t capacity);
+    void clear();
+};
+
+#endif // FORMULA_CACHE_H
@@ -0,0 +1,206 @@
+#ifndef FORMULA_LITERAL_H
+#define FORMULA_LITERAL_H
+
+#include "CompoundDatabase.h"
+#include "ElementTable.h"
+#include "EquationTokenizer.h"
+#include "ParseDiagnostic.h"
+#include <array>
+#include <string_view>
+#include <cstdint>
+#include <limits>
+
+// A formula parsed at compile time:
+//
+//     constexpr FormulaLiteral lime = "Ca(OH)2"_formula;
+//     static_assert(lime.ok() && lime.count("O") == 2);
+//
+// Follows the same grammar, diagnostics and molar mass arithmetic as
+// ChemicalCompound, and converts to one without reparsing.
+class FormulaLiteral {
+public:
+    static constexpr size_t MAX_GROUP_DEPTH = 32;
+
+private:
+    using Counts = std::array<int64_t, CompoundDatabase::MAX_ATOMIC_NUMBER + 1>;
+    using Presence = std::array<bool, CompoundDatabase::MAX_ATOMIC_NUMBER + 1>;
+
+    std::string_view formula_; // literals have static storage
+    Counts counts_;
+    Presence present_;
+    ParseDiagnostic diagnostic_;
+    size_t size_;
+    double molarMass_;
+
+    static constexpr bool isDigit(char c) { return c >= '0' && c <= '9'; }
+    static constexpr bool isUpper(char c) { return c >= 'A' && c <= 'Z'; }
+    static constexpr bool isLower(char c) { return c >= 'a' && c <= 'z'; }
+
+    static constexpr bool multiplyCount(int64_t a, int64_t b, int64_t& result) {
+        if (a != 0 && b > std::numeric_limits<int64_t>::max() / a) {
+            return false;
+        }
+        result = a * b;
+        return true;
+    }
+
+    static constexpr bool addCount(int64_t a, int64_t b, int64_t& result) {
+        if (a > std::numeric_limits<int64_t>::max() - b) {
+            return false;
+        }
+        result = a + b;
+        return true;
+    }
+
+    // Same right-to-left pass as ChemicalCompound::parseFormula, with a
+    // fixed-size group stack instead of a vector
+    static constexpr ParseDiagnostic parse(std::string_view formula, Counts& counts, Presence& present) {
+        int64_t multipliers[MAX_GROUP_DEPTH + 1] = {1};
+        size_t positions[MAX_GROUP_DEPTH + 1] = {0};
+        size_t depth = 0;
+        int64_t pending = 1;
+        size_t pendingPosition = 0;
+        bool hasPending = false;
+        bool hasElement = false;
+
+        size_t i = formula.length();
+        while (i > 0) {
+            char c = formula[i - 1];
+
+            if (EquationTokenizer::isWhitespace(c)) {
+                --i;
+
+            } else if (isDigit(c)) {
+                size_t digitsEnd = i;
+                while (i > 0 && isDigit(formula[i - 1])) {
+                    --i;
+                }
+
+                pending = 0;
+                for (size_t d = i; d < digitsEnd; ++d) {
+                    if (!multiplyCount(pending, 10, pending) || !addCount(pending, formula[d] - '0', pending)) {
+                        return {ParseStatus::COUNT_OVERFLOW, i, "Count too large"};
+                    }
+                }
+                pendingPosition = i;
+                hasPending = true;
+
+            } else if (c == ')') {
+                if (size_t stateLength = EquationTokenizer::stateLengthBefore(formula, i)) {
+                    i -= stateLength;
+                    continue;
+                }
+
+                if (depth == MAX_GROUP_DEPTH) {
+                    return {ParseStatus::NESTING_TOO_DEEP, i - 1, "Groups nested too deeply"};
+                }
+                int64_t groupMultiplier = 0;
+                if (!multiplyCount(multipliers[depth], pending, groupMultiplier)) {
+                    return {ParseStatus::COUNT_OVERFLOW, i - 1, "Group multiplier overflow"};
+                }
+                ++depth;
+                multipliers[depth] = groupMultiplier;
+                positions[depth] = i - 1;
+                pending = 1;
+                hasPending = false;
+                --i;
+
+            } else if (c == '(') {
+                if (hasPending) {
+                    return {ParseStatus::INVALID_CHARACTER, pendingPosition, "Number not attached to an element or group"};
+                }
+                if (depth == 0) {
+                    return {ParseStatus::UNMATCHED_PARENTHESIS, i - 1, "Unmatched '('"};
+                }
+                --depth;
+                --i;
+
+            } else if (isUpper(c) || isLower(c)) {
+                size_t symbolEnd = i;
+                while (i > 0 && isLower(formula[i - 1])) {
+                    --i;
+                }
+                if (i == 0 || !isUpper(formula[i - 1])) {
+                    return {ParseStatus::INVALID_CHARACTER, i, "Element symbol must start with an uppercase letter"};
+                }
+                --i;
+
+                int atomicNumber = findAtomicNumber(formula.substr(i, symbolEnd - i));
+                if (atomicNumber == 0) {
+                    return {ParseStatus::UNKNOWN_ELEMENT, i, "Unknown element"};
+                }
+
+                int64_t count = 0;
+                if (!multiplyCount(multipliers[depth], pending, count) ||
+                    !addCount(counts[atomicNumber], count, counts[atomicNumber])) {
+                    return {ParseStatus::COUNT_OVERFLOW, i, "Element count overflow"};
+                }
+                present[atomicNumber] = true;
+                hasElement = true;
+                pending = 1;
+                hasPending = false;
+
+            } else {
+                return {ParseStatus::INVALID_CHARACTER, i - 1, "Invalid character"};
+            }
+        }
+
+        if (hasPending) {
+            return {ParseStatus::INVALID_CHARACTER, pendingPosition, "Number not attached to an element or group"};
+        }
+        if (depth != 0) {
+            return {ParseStatus::UNMATCHED_PARENTHESIS, positions[1], "Unmatched ')'"};
+        }
+        if (!hasElement) {
+            return {ParseStatus::EMPTY_FORMULA, 0, "Formula has no elements"};
+        }
+
+        return ParseDiagnostic::success();
+    }
+
+public:
+    constexpr explicit FormulaLiteral(std::string_view formula)
+        : formula_(formula), counts_{}, present_{},
+          diagnostic_(parse(formula, counts_, present_)), size_(0), molarMass_(0.0) {
+        if (!diagnostic_.ok()) {
+            counts_ = Counts{};
+            present_ = Presence{};
+            return;
+        }
+
+        // Ascending atomic number, as in ChemicalCompound::calculateMolarMass,
+        // so both produce bit-identical masses
+        for (int atomicNumber = 1; atomicNumber <= CompoundDatabase::MAX_ATOMIC_NUMBER; ++atomicNumber) {
+            if (present_[atomicNumber]) {
+                ++size_;
+                molarMass_ += findAtomicMass(atomicNumber) * counts_[atomicNumber];
+            }
+        }
+    }
+
+    constexpr std::string_view formula() const { return formula_; }
+    constexpr bool ok() const { return diagnostic_.ok(); }
+    constexpr const ParseDiagnostic& diagnostic() const { return diagnostic_; }
+    constexpr double molarMass() const { return molarMass_; }
+
+    // Number of distinct elements
+    constexpr size_t size() const { return size_; }
+
+    constexpr bool contains(int atomicNumber) const {
+        return atomicNumber > 0 && atomicNumber <= CompoundDatabase::MAX_ATOMIC_NUMBER && present_[atomicNumber];
+    }
+
+    constexpr int64_t count(int atomicNumber) const {
+        return contains(atomicNumber) ? counts_[atomicNumber] : 0;
+    }
+
+    constexpr int64_t count(std::string_view symbol) const {
+        return count(findAtomicNumber(symbol));
+    }
+};
+
+constexpr FormulaLiteral operator""_formula(const char* text, size_t length) {
+    return FormulaLiteral(std::string_view(text, length));
+}
+
+#endif // FORMULA_LITERAL_H
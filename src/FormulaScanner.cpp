@@ -0,0 +1,257 @@
+#include "FormulaScanner.h"
+#include "ChemicalCompound.h"
+#include "CompoundDatabase.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FORMULA_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+const uint8_t* FormulaScanner::classTable() {
+    static const std::array<uint8_t, 256> table = []() {
+        std::array<uint8_t, 256> classes{};
+        for (int c = 'A'; c <= 'Z'; ++c) classes[c] = CHAR_UPPER;
+        for (int c = 'a'; c <= 'z'; ++c) classes[c] = CHAR_LOWER;
+        for (int c = '0'; c <= '9'; ++c) classes[c] = CHAR_DIGIT;
+        classes['('] = CHAR_OPEN;
+        classes[')'] = CHAR_CLOSE;
+        for (char c : {' ', '\t', '\n', '\r', '\f', '\v'}) classes[static_cast<unsigned char>(c)] = CHAR_SPACE;
+        return classes;
+    }();
+    return table.data();
+}
+
+ClassMasks FormulaScanner::classifyScalar(const char* data, size_t length) {
+    ClassMasks masks = {0, 0, 0, 0, 0, 0, 0};
+    const uint8_t* classes = classTable();
+
+    for (size_t i = 0; i < length; ++i) {
+        uint32_t bit = 1u << i;
+        switch (classes[static_cast<unsigned char>(data[i])]) {
+            case CHAR_UPPER: masks.upper |= bit; break;
+            case CHAR_LOWER: masks.lower |= bit; break;
+            case CHAR_DIGIT: masks.digit |= bit; break;
+            case CHAR_OPEN: masks.open |= bit; break;
+            case CHAR_CLOSE: masks.close |= bit; break;
+            case CHAR_SPACE: masks.space |= bit; break;
+            default: masks.other |= bit; break;
+        }
+    }
+
+    return masks;
+}
+
+#ifdef FORMULA_SCANNER_X86
+
+__attribute__((target("avx2")))
+static inline __m256i inRange256(__m256i bytes, char low, char high) {
+    // Signed compares are enough: every class is plain ASCII, bytes >= 0x80 fall outside
+    return _mm256_and_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8(static_cast<char>(low - 1))),
+                            _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(high + 1)), bytes));
+}
+
+__attribute__((target("avx2")))
+static ClassMasks classifyAvx2(const char* data) {
+    __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+
+    ClassMasks masks;
+    masks.upper = static_cast<uint32_t>(_mm256_movemask_epi8(inRange256(bytes, 'A', 'Z')));
+    masks.lower = static_cast<uint32_t>(_mm256_movemask_epi8(inRange256(bytes, 'a', 'z')));
+    masks.digit = static_cast<uint32_t>(_mm256_movemask_epi8(inRange256(bytes, '0', '9')));
+    masks.open = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('('))));
+    masks.close = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(')'))));
+    masks.space = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(
+        _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' ')), inRange256(bytes, '\t', '\r'))));
+    masks.other = ~(masks.upper | masks.lower | masks.digit | masks.open | masks.close | masks.space);
+    return masks;
+}
+
+#endif // FORMULA_SCANNER_X86
+
+#if defined(__SSE2__)
+
+static inline __m128i inRange128(__m128i bytes, char low, char high) {
+    return _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8(static_cast<char>(low - 1))),
+                         _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(high + 1)), bytes));
+}
+
+static ClassMasks classifySse2(const char* data) {
+    ClassMasks masks = {0, 0, 0, 0, 0, 0, 0};
+
+    for (int half = 0; half < 2; ++half) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * half));
+        int shift = 16 * half;
+
+        masks.upper |= static_cast<uint32_t>(_mm_movemask_epi8(inRange128(bytes, 'A', 'Z'))) << shift;
+        masks.lower |= static_cast<uint32_t>(_mm_movemask_epi8(inRange128(bytes, 'a', 'z'))) << shift;
+        masks.digit |= static_cast<uint32_t>(_mm_movemask_epi8(inRange128(bytes, '0', '9'))) << shift;
+        masks.open |= static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('(')))) << shift;
+        masks.close |= static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(')')))) << shift;
+        masks.space |= static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(
+            _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')), inRange128(bytes, '\t', '\r')))) << shift;
+    }
+
+    masks.other = ~(masks.upper | masks.lower | masks.digit | masks.open | masks.close | masks.space);
+    return masks;
+}
+
+#endif // __SSE2__
+
+bool FormulaScanner::usesAvx2() {
+#ifdef FORMULA_SCANNER_X86
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+ClassMasks FormulaScanner::classifyBlock(const char* data, size_t length) {
+#if defined(FORMULA_SCANNER_X86) || defined(__SSE2__)
+    // Short tails are padded so the vector loads never read past the input
+    char padded[BLOCK_SIZE];
+    if (length < BLOCK_SIZE) {
+        std::memset(padded, 0, sizeof(padded));
+        std::memcpy(padded, data, length);
+        data = padded;
+    }
+
+    ClassMasks masks;
+#ifdef FORMULA_SCANNER_X86
+    if (usesAvx2()) {
+        masks = classifyAvx2(data);
+    } else
+#endif
+    {
+#if defined(__SSE2__)
+        masks = classifySse2(data);
+#else
+        masks = classifyScalar(data, BLOCK_SIZE);
+#endif
+    }
+
+    if (length < BLOCK_SIZE) {
+        uint32_t valid = (1u << length) - 1;
+        masks.upper &= valid;
+        masks.lower &= valid;
+        masks.digit &= valid;
+        masks.open &= valid;
+        masks.close &= valid;
+        masks.space &= valid;
+        masks.other &= valid;
+    }
+    return masks;
+#else
+    return classifyScalar(data, length < BLOCK_SIZE ? length : BLOCK_SIZE);
+#endif
+}
+
+static inline int popcount32(uint32_t value) {
+#if defined(__GNUC__)
+    return __builtin_popcount(value);
+#else
+    int count = 0;
+    for (; value; value &= value - 1) ++count;
+    return count;
+#endif
+}
+
+static inline int lowestBit(uint32_t value) {
+#if defined(__GNUC__)
+    return __builtin_ctz(value);
+#else
+    int bit = 0;
+    while (!(value & 1u)) { value >>= 1; ++bit; }
+    return bit;
+#endif
+}
+
+// Proves a formula valid from the class masks alone. Returns false for
+// anything unusual, leaving the exact diagnosis to the parser.
+static bool acceptInBulk(std::string_view formula) {
+    // Numbers below 1000 nested at most three groups deep multiply to less
+    // than 10^12 per atom, so a million-character formula cannot overflow
+    const int64_t MAX_DEPTH = 3;
+    const size_t MAX_LENGTH = 1000000;
+
+    if (formula.empty() || formula.size() > MAX_LENGTH) {
+        return false;
+    }
+
+    CompoundDatabase& db = CompoundDatabase::getInstance();
+    int64_t depth = 0;
+    int64_t maxDepth = 0;
+    bool hasElement = false;
+    uint32_t carryUpper = 0;
+    uint32_t carryDigit = 0;
+    uint32_t carryOpen = 0;
+
+    for (size_t start = 0; start < formula.size(); start += FormulaScanner::BLOCK_SIZE) {
+        size_t length = std::min(FormulaScanner::BLOCK_SIZE, formula.size() - start);
+        ClassMasks masks = FormulaScanner::classifyBlock(formula.data() + start, length);
+
+        // Whitespace and state suffixes are rare enough to leave to the parser
+        if (masks.other | masks.space) {
+            return false;
+        }
+
+        // A lowercase letter may only be the second letter of a symbol
+        if (masks.lower & ~((masks.upper << 1) | carryUpper)) {
+            return false;
+        }
+
+        // Numbers must follow an element or a closing parenthesis
+        uint32_t numberStarts = masks.digit & ~((masks.digit << 1) | (carryDigit >> 31));
+        if ((numberStarts & ((masks.open << 1) | carryOpen)) || (start == 0 && (masks.digit & 1u))) {
+            return false;
+        }
+
+        // Four digits in a row, counting the last three of the previous block
+        uint64_t digitRun = (static_cast<uint64_t>(masks.digit) << 3) | (carryDigit >> 29);
+        if (digitRun & (digitRun >> 1) & (digitRun >> 2) & (digitRun >> 3)) {
+            return false;
+        }
+
+        // Parenthesis depth: only blocks that close a group need the ordered walk
+        if (masks.close == 0) {
+            depth += popcount32(masks.open);
+            maxDepth = std::max(maxDepth, depth);
+        } else {
+            for (uint32_t parens = masks.open | masks.close; parens; parens &= parens - 1) {
+                uint32_t bit = 1u << lowestBit(parens);
+                depth += (masks.open & bit) ? 1 : -1;
+                if (depth < 0) {
+                    return false;
+                }
+                maxDepth = std::max(maxDepth, depth);
+            }
+        }
+
+        // Element symbols start at every uppercase letter
+        for (uint32_t uppers = masks.upper; uppers; uppers &= uppers - 1) {
+            size_t pos = start + lowestBit(uppers);
+            size_t symbolLength = (pos + 1 < formula.size() &&
+                                   FormulaScanner::classOf(formula[pos + 1]) == CHAR_LOWER) ? 2 : 1;
+            if (db.getAtomicNumber(formula.substr(pos, symbolLength)) == 0) {
+                return false;
+            }
+            hasElement = true;
+        }
+
+        carryUpper = masks.upper >> 31;
+        carryDigit = masks.digit;
+        carryOpen = masks.open >> 31;
+    }
+
+    return depth == 0 && maxDepth <= MAX_DEPTH && hasElement;
+}
+
+ParseDiagnostic FormulaScanner::validate(std::string_view formula) {
+    if (acceptInBulk(formula)) {
+        return ParseDiagnostic::success();
+    }
+    return ChemicalCompound(formula).getParseDiagnostic();
+}
@@ -0,0 +1,57 @@
+#ifndef FORMULA_SCANNER_H
+#define FORMULA_SCANNER_H
+
+#include "ParseDiagnostic.h"
+#include <string_view>
+#include <cstdint>
+
+// Character classes used by the formula parser
+enum CharClass : uint8_t {
+    CHAR_OTHER = 0,
+    CHAR_UPPER = 1,
+    CHAR_LOWER = 2,
+    CHAR_DIGIT = 4,
+    CHAR_OPEN = 8,
+    CHAR_CLOSE = 16,
+    CHAR_SPACE = 32
+};
+
+// One bit per byte of a 32-byte block, bit i set when byte i is in the class
+struct ClassMasks {
+    uint32_t upper;
+    uint32_t lower;
+    uint32_t digit;
+    uint32_t open;
+    uint32_t close;
+    uint32_t space;
+    uint32_t other;
+};
+
+// Vectorized pre-pass for bulk formula validation. Blocks of 32 bytes are
+// classified with AVX2 when the CPU supports it, with SSE2 otherwise and
+// with a table lookup on other targets. Token boundaries and parenthesis
+// depth are then derived from the masks a block at a time.
+class FormulaScanner {
+private:
+    static const uint8_t* classTable();
+    static ClassMasks classifyScalar(const char* data, size_t length);
+
+public:
+    static constexpr size_t BLOCK_SIZE = 32;
+
+    static uint8_t classOf(char c) { return classTable()[static_cast<unsigned char>(c)]; }
+
+    // Classifies up to BLOCK_SIZE bytes; bits past length are left clear
+    static ClassMasks classifyBlock(const char* data, size_t length);
+
+    // Same result as parsing the formula with ChemicalCompound, without
+    // building element counts. Formulas the bulk pass cannot prove valid
+    // (whitespace, state suffixes, huge counts, any error) are handed to
+    // the parser for an exact diagnostic.
+    static ParseDiagnostic validate(std::string_view formula);
+
+    // True when the build and the running CPU use the AVX2 path
+    static bool usesAvx2();
+};
+
+#endif // FORMULA_SCANNER_H
@@ -0,0 +1,484 @@
+#include "LatticeSolver.h"
+#include "CheckedArithmetic.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+using Rows = std::vector<std::vector<int64_t>>;
+
+// row -= multiple * pivot
+void subtractMultiple(std::vector<int64_t>& row, const std::vector<int64_t>& pivot, int64_t multiple) {
+    if (multiple == 0) {
+        return;
+    }
+    for (size_t j = 0; j < row.size(); ++j) {
+        row[j] = checkedSubtract(row[j], checkedMultiply(multiple, pivot[j]));
+    }
+}
+
+int64_t floorDivide(int64_t a, int64_t b) {
+    int64_t quotient = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? quotient - 1 : quotient;
+}
+
+// Unimodular row reduction to echelon form on the first columnCount
+// columns, by repeated division with remainder. With reduceAbove the
+// pivots are made positive and the entries above them reduced into
+// [0, pivot), which is the Hermite normal form. Returns the rank.
+size_t echelon(Rows& rows, size_t columnCount, bool reduceAbove) {
+    size_t rank = 0;
+    for (size_t col = 0; col < columnCount && rank < rows.size(); ++col) {
+        while (true) {
+            size_t smallest = rows.size();
+            for (size_t i = rank; i < rows.size(); ++i) {
+                if (rows[i][col] != 0 &&
+                    (smallest == rows.size() || std::abs(rows[i][col]) < std::abs(rows[smallest][col]))) {
+                    smallest = i;
+                }
+            }
+            if (smallest == rows.size()) {
+                break;
+            }
+            std::swap(rows[rank], rows[smallest]);
+
+            bool cleared = true;
+            for (size_t i = rank + 1; i < rows.size(); ++i) {
+                subtractMultiple(rows[i], rows[rank], rows[i][col] / rows[rank][col]);
+                cleared = cleared && rows[i][col] == 0;
+            }
+            if (cleared) {
+                break;
+            }
+        }
+        if (rank == rows.size() || rows[rank][col] == 0) {
+            continue;
+        }
+
+        if (reduceAbove) {
+            if (rows[rank][col] < 0) {
+                for (int64_t& value : rows[rank]) {
+                    value = checkedSubtract(0, value);
+                }
+            }
+            for (size_t i = 0; i < rank; ++i) {
+                subtractMultiple(rows[i], rows[rank], floorDivide(rows[i][col], rows[rank][col]));
+            }
+        }
+        ++rank;
+    }
+    return rank;
+}
+
+double dot(const std::vector<double>& a, const std::vector<double>& b) {
+    double sum = 0.0;
+    for (size_t j = 0; j < a.size(); ++j) {
+        sum += a[j] * b[j];
+    }
+    return sum;
+}
+
+// Gram-Schmidt coefficients mu[i][j] and squared lengths of the
+// orthogonalised vectors, in double
+void gramSchmidt(const Rows& basis, std::vector<std::vector<double>>& mu, std::vector<double>& lengths) {
+    size_t count = basis.size();
+    std::vector<std::vector<double>> orthogonal(count);
+    mu.assign(count, std::vector<double>(count, 0.0));
+    lengths.assign(count, 0.0);
+    for (size_t i = 0; i < count; ++i) {
+        std::vector<double> vector(basis[i].begin(), basis[i].end());
+        orthogonal[i] = vector;
+        for (size_t j = 0; j < i; ++j) {
+            mu[i][j] = dot(vector, orthogonal[j]) / lengths[j];
+            for (size_t k = 0; k < vector.size(); ++k) {
+                orthogonal[i][k] -= mu[i][j] * orthogonal[j][k];
+            }
+        }
+        mu[i][i] = 1.0;
+        lengths[i] = dot(orthogonal[i], orthogonal[i]);
+    }
+}
+
+// One inequality of the relaxation: coefficients . c >= bound
+struct Constraint {
+    std::vector<double> coefficients;
+    double bound;
+};
+
+// Minimises objective . c over real c subject to the constraints. The
+// dual, max bound . y subject to sum of y_k * coefficients_k = objective
+// and y >= 0, is in standard form and solved by the two-phase tableau
+// simplex with Bland's rule; the optimal c are its simplex multipliers.
+// Returns false when the constraints are infeasible.
+bool minimizeRelaxation(const std::vector<Constraint>& constraints, const std::vector<double>& objective,
+                        std::vector<double>& solution, double& value) {
+    const double epsilon = 1e-9;
+    size_t rows = objective.size();
+    size_t count = constraints.size();
+    size_t width = count + rows + 1; // constraints, artificials, right-hand side
+
+    std::vector<std::vector<double>> tableau(rows, std::vector<double>(width, 0.0));
+    std::vector<double> sign(rows, 1.0);
+    std::vector<size_t> basis(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        sign[i] = objective[i] < 0 ? -1.0 : 1.0;
+        for (size_t k = 0; k < count; ++k) {
+            tableau[i][k] = sign[i] * constraints[k].coefficients[i];
+        }
+        tableau[i][count + i] = 1.0;
+        tableau[i][width - 1] = sign[i] * objective[i];
+        basis[i] = count + i;
+    }
+
+    auto pivot = [&](size_t row, size_t col) {
+        double scale = tableau[row][col];
+        for (double& entry : tableau[row]) {
+            entry /= scale;
+        }
+        for (size_t i = 0; i < rows; ++i) {
+            double factor = tableau[i][col];
+            if (i != row && factor != 0.0) {
+                for (size_t j = 0; j < width; ++j) {
+                    tableau[i][j] -= factor * tableau[row][j];
+                }
+            }
+        }
+        basis[row] = col;
+    };
+
+    // Maximises cost over the columns below limit; false when unbounded
+    auto maximize = [&](const std::vector<double>& cost, size_t limit) {
+        while (true) {
+            size_t entering = limit;
+            for (size_t j = 0; j < limit && entering == limit; ++j) {
+                double reduced = cost[j];
+                for (size_t i = 0; i < rows; ++i) {
+                    reduced -= cost[basis[i]] * tableau[i][j];
+                }
+                if (reduced > epsilon) {
+                    entering = j;
+                }
+            }
+            if (entering == limit) {
+                return true;
+            }
+
+            size_t leaving = rows;
+            double bestRatio = 0.0;
+            for (size_t i = 0; i < rows; ++i) {
+                if (tableau[i][entering] > epsilon) {
+                    double ratio = tableau[i][width - 1] / tableau[i][entering];
+                    if (leaving == rows || ratio < bestRatio - epsilon ||
+                        (ratio < bestRatio + epsilon && basis[i] < basis[leaving])) {
+                        leaving = i;
+                        bestRatio = ratio;
+                    }
+                }
+            }
+            if (leaving == rows) {
+                return false;
+            }
+            pivot(leaving, entering);
+        }
+    };
+
+    // Phase one drives the artificials to zero and then out of the basis
+    std::vector<double> cost(width - 1, 0.0);
+    for (size_t i = 0; i < rows; ++i) {
+        cost[count + i] = -1.0;
+    }
+    maximize(cost, width - 1);
+    for (size_t i = 0; i < rows; ++i) {
+        if (basis[i] >= count && tableau[i][width - 1] > 1e-7) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < rows; ++i) {
+        if (basis[i] >= count) {
+            for (size_t k = 0; k < count; ++k) {
+                if (std::abs(tableau[i][k]) > epsilon) {
+                    pivot(i, k);
+                    break;
+                }
+            }
+        }
+    }
+
+    // An unbounded dual means no c satisfies the constraints
+    std::fill(cost.begin(), cost.end(), 0.0);
+    for (size_t k = 0; k < count; ++k) {
+        cost[k] = constraints[k].bound;
+    }
+    if (!maximize(cost, count)) {
+        return false;
+    }
+
+    // The artificial columns hold the inverse basis, so they give the
+    // multipliers directly
+    solution.assign(rows, 0.0);
+    value = 0.0;
+    for (size_t i = 0; i < rows; ++i) {
+        if (basis[i] < count) {
+            value += cost[basis[i]] * tableau[i][width - 1];
+        }
+        for (size_t r = 0; r < rows; ++r) {
+            if (basis[r] < count) {
+                solution[i] += cost[basis[r]] * tableau[r][count + i];
+            }
+        }
+        solution[i] *= sign[i];
+    }
+    return true;
+}
+
+// Depth-first branch and bound over the coefficients of an LLL basis. The
+// relaxation keeps every entry of x = sum c_i b_i at least 1 and branches
+// on the most fractional c_i. Since coefficient sums are integers, a node
+// whose bound rounds up to the best sum found so far is pruned.
+class PositiveSearch {
+public:
+    static constexpr int MAX_SEED_MULTIPLE = 1000;
+
+private:
+    const Rows& basis_;
+    std::vector<Constraint> positivity_; // x_j >= 1 for every entry
+    std::vector<double> objective_;      // coefficient sum of each basis vector
+    // Branching bounds on each coefficient, infinite while unset; tightened
+    // in place so the relaxation never grows beyond n + 2d rows
+    std::vector<double> lower_;
+    std::vector<double> upper_;
+    size_t budget_;
+
+    bool relax(std::vector<double>& relaxed, double& bound) const {
+        std::vector<Constraint> constraints = positivity_;
+        for (size_t i = 0; i < lower_.size(); ++i) {
+            if (lower_[i] != -HUGE_VAL) {
+                Constraint limit{std::vector<double>(lower_.size(), 0.0), lower_[i]};
+                limit.coefficients[i] = 1.0;
+                constraints.push_back(limit);
+            }
+            if (upper_[i] != HUGE_VAL) {
+                Constraint limit{std::vector<double>(upper_.size(), 0.0), -upper_[i]};
+                limit.coefficients[i] = -1.0;
+                constraints.push_back(limit);
+            }
+        }
+        return minimizeRelaxation(constraints, objective_, relaxed, bound);
+    }
+
+public:
+    size_t nodes = 0;
+    bool exhausted = false;
+    int64_t bestSum = 0; // 0 while nothing is found
+    std::vector<int64_t> best;
+
+    PositiveSearch(const Rows& basis, size_t budget)
+        : basis_(basis), objective_(basis.size(), 0.0), lower_(basis.size(), -HUGE_VAL),
+          upper_(basis.size(), HUGE_VAL), budget_(budget) {
+        size_t width = basis[0].size();
+        for (size_t j = 0; j < width; ++j) {
+            Constraint positive{std::vector<double>(basis.size()), 1.0};
+            for (size_t i = 0; i < basis.size(); ++i) {
+                positive.coefficients[i] = static_cast<double>(basis[i][j]);
+                objective_[i] += static_cast<double>(basis[i][j]);
+            }
+            positivity_.push_back(positive);
+        }
+    }
+
+    // The relaxed optimum is a rational point of the cone x >= 1, so some
+    // multiple of it is a positive lattice vector. Without such a bound the
+    // region is unbounded and a depth-first search can dive forever.
+    void seedFromRelaxation() {
+        std::vector<double> relaxed;
+        double bound;
+        if (!relax(relaxed, bound)) {
+            return;
+        }
+        for (int multiple = 1; multiple <= MAX_SEED_MULTIPLE && bestSum == 0; ++multiple) {
+            std::vector<double> scaled(relaxed);
+            bool integral = true;
+            for (double& value : scaled) {
+                value *= multiple;
+                integral = integral && std::abs(value - std::round(value)) < 1e-6;
+            }
+            if (integral) {
+                visitIntegral(scaled);
+            }
+        }
+    }
+
+    void run() {
+        if (++nodes > budget_) {
+            exhausted = true;
+            return;
+        }
+
+        std::vector<double> relaxed;
+        double bound;
+        if (!relax(relaxed, bound)) {
+            return;
+        }
+        if (bestSum != 0 && std::ceil(bound - 1e-6) >= static_cast<double>(bestSum)) {
+            return;
+        }
+
+        size_t branch = relaxed.size();
+        double fraction = 1e-6;
+        for (size_t i = 0; i < relaxed.size(); ++i) {
+            double distance = std::abs(relaxed[i] - std::round(relaxed[i]));
+            if (distance > fraction) {
+                branch = i;
+                fraction = distance;
+            }
+        }
+        if (branch == relaxed.size()) {
+            visitIntegral(relaxed);
+            return;
+        }
+
+        // The nearer side first, then the other
+        double below = std::floor(relaxed[branch]);
+        bool upFirst = relaxed[branch] - below > 0.5;
+        for (int side = 0; side < 2 && !exhausted; ++side) {
+            bool up = (side == 0) == upFirst;
+            double& limit = up ? lower_[branch] : upper_[branch];
+            double saved = limit;
+            limit = up ? below + 1.0 : below;
+            run();
+            limit = saved;
+        }
+    }
+
+private:
+    // The relaxation is in floating point, so the rounded point is checked
+    // exactly before it counts
+    void visitIntegral(const std::vector<double>& relaxed) {
+        std::vector<int64_t> vector(basis_[0].size(), 0);
+        int64_t sum = 0;
+        try {
+            for (size_t i = 0; i < basis_.size(); ++i) {
+                subtractMultiple(vector, basis_[i], -std::llround(relaxed[i]));
+            }
+            for (int64_t value : vector) {
+                if (value <= 0) {
+                    return;
+                }
+                sum = checkedAdd(sum, value);
+            }
+        } catch (const std::overflow_error&) {
+            return;
+        }
+        if (bestSum == 0 || sum < bestSum) {
+            bestSum = sum;
+            best = vector;
+        }
+    }
+};
+
+} // namespace
+
+LatticeSolver::LatticeSolver() : searchBudget_(DEFAULT_SEARCH_BUDGET), nodesVisited_(0), provenMinimal_(false) {
+    solver_.setRecordSteps(false);
+}
+
+void LatticeSolver::setSearchBudget(size_t nodes) {
+    searchBudget_ = nodes;
+}
+
+size_t LatticeSolver::getSearchBudget() const {
+    return searchBudget_;
+}
+
+std::vector<std::vector<int64_t>> LatticeSolver::integerNullspace(const DenseMatrix<int64_t>& matrix) {
+    size_t rows = matrix.rows();
+    size_t cols = matrix.cols();
+
+    // Row j of [A^T | I] is column j of A followed by e_j; whatever unimodular
+    // combination clears the A^T part leaves a null vector in the I part
+    Rows augmented(cols, std::vector<int64_t>(rows + cols, 0));
+    for (size_t j = 0; j < cols; ++j) {
+        for (size_t i = 0; i < rows; ++i) {
+            augmented[j][i] = matrix[i][j];
+        }
+        augmented[j][rows + j] = 1;
+    }
+    size_t rank = echelon(augmented, rows, false);
+
+    Rows basis;
+    for (size_t j = rank; j < cols; ++j) {
+        basis.emplace_back(augmented[j].begin() + rows, augmented[j].end());
+    }
+    echelon(basis, cols, true);
+    return basis;
+}
+
+void LatticeSolver::lllReduce(std::vector<std::vector<int64_t>>& basis) {
+    const double delta = 0.75;
+    std::vector<std::vector<double>> mu;
+    std::vector<double> lengths;
+    gramSchmidt(basis, mu, lengths);
+
+    size_t k = 1;
+    while (k < basis.size()) {
+        bool reduced = false;
+        for (size_t j = k; j-- > 0;) {
+            int64_t multiple = std::llround(mu[k][j]);
+            if (multiple != 0) {
+                subtractMultiple(basis[k], basis[j], multiple);
+                for (size_t l = 0; l <= j; ++l) {
+                    mu[k][l] -= static_cast<double>(multiple) * mu[j][l];
+                }
+                reduced = true;
+            }
+        }
+        if (reduced) {
+            gramSchmidt(basis, mu, lengths);
+        }
+
+        if (lengths[k] >= (delta - mu[k][k - 1] * mu[k][k - 1]) * lengths[k - 1]) {
+            ++k;
+        } else {
+            std::swap(basis[k], basis[k - 1]);
+            gramSchmidt(basis, mu, lengths);
+            k = std::max<size_t>(k - 1, 1);
+        }
+    }
+}
+
+std::vector<int64_t> LatticeSolver::minimalPositive(const DenseMatrix<int64_t>& matrix) {
+    nodesVisited_ = 0;
+    provenMinimal_ = false;
+
+    // Dimension 0 or 1 leaves nothing to search: the one primitive vector or
+    // its negation is the answer, if either is positive
+    DenseMatrix<int64_t> work = matrix;
+    auto rational = solver_.nullspaceBasis(work);
+    if (rational.size() <= 1) {
+        provenMinimal_ = true;
+        if (rational.empty()) {
+            return {};
+        }
+        std::vector<int64_t> vector = rational[0];
+        bool positive = std::all_of(vector.begin(), vector.end(), [](int64_t value) { return value > 0; });
+        bool negative = std::all_of(vector.begin(), vector.end(), [](int64_t value) { return value < 0; });
+        if (negative) {
+            for (int64_t& value : vector) {
+                value = -value;
+            }
+        }
+        return positive || negative ? vector : std::vector<int64_t>();
+    }
+
+    Rows basis = integerNullspace(matrix);
+    lllReduce(basis);
+
+    PositiveSearch search(basis, searchBudget_);
+    search.seedFromRelaxation();
+    search.run();
+    provenMinimal_ = !search.exhausted;
+
+    nodesVisited_ = std::min(search.nodes, searchBudget_);
+    return search.best;
+}
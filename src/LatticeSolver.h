@@ -0,0 +1,60 @@
+#ifndef LATTICE_SOLVER_H
+#define LATTICE_SOLVER_H
+
+#include "DenseMatrix.h"
+#include "MatrixSolver.h"
+#include <vector>
+#include <cstdint>
+
+// Smallest strictly positive integer solution of A x = 0 when the
+// nullspace has more than one dimension. MatrixSolver's basis vectors each
+// fix the free variables to one choice; here the whole integer lattice of
+// solutions is searched instead:
+//
+// 1. A Z-basis of {x in Z^n : A x = 0} from a unimodular reduction of
+//    [A^T | I], put in Hermite normal form.
+// 2. LLL reduction of that basis, which makes its vectors short and
+//    nearly orthogonal.
+// 3. Branch and bound on the coefficients of x in the reduced basis, the
+//    lattice reformulation of Aardal, Hurkens and Lenstra. Each node's
+//    bound comes from the linear relaxation x >= 1, and a search that
+//    completes proves the best vector minimal.
+//
+// "Smallest" is the least coefficient sum; ties go to the vector found
+// first. Integer arithmetic is checked and throws std::overflow_error.
+class LatticeSolver {
+public:
+    // Branch-and-bound nodes visited before giving up
+    static constexpr size_t DEFAULT_SEARCH_BUDGET = 20000;
+
+private:
+    MatrixSolver solver_;
+    size_t searchBudget_;
+    size_t nodesVisited_;
+    bool provenMinimal_;
+
+public:
+    LatticeSolver();
+
+    void setSearchBudget(size_t nodes);
+    size_t getSearchBudget() const;
+
+    // Lattice basis of the integer nullspace in Hermite normal form: row
+    // echelon, each pivot positive and the entries above it in [0, pivot)
+    static std::vector<std::vector<int64_t>> integerNullspace(const DenseMatrix<int64_t>& matrix);
+
+    // LLL reduction with delta = 3/4; the rows stay a basis of the same lattice
+    static void lllReduce(std::vector<std::vector<int64_t>>& basis);
+
+    // Strictly positive null vector with the smallest coefficient sum, or
+    // empty when there is none or the budget ran out first. A nullspace of
+    // dimension 1 is answered from MatrixSolver without a search.
+    std::vector<int64_t> minimalPositive(const DenseMatrix<int64_t>& matrix);
+
+    // Statistics of the last minimalPositive call: nodes visited, and
+    // whether the search finished, so that a returned vector is the minimum
+    size_t nodesVisited() const { return nodesVisited_; }
+    bool isProvenMinimal() const { return provenMinimal_; }
+};
+
+#endif // LATTICE_SOLVER_H
@@ -13,6 +13,12 @@ MainWindow::MainWindow(QWidget *parent)
     , classifier_()
     , centralWidget_(nullptr)
 {
+    // The live preview only needs coefficients; the math tab is filled from balancer_.
+    // It shows nothing for several independent reactions, so it skips the
+    // smallest combination search that would otherwise run on every keystroke.
+    previewBalancer_.setRecordSteps(false);
+    previewBalancer_.setMinimalSearchBudget(0);
+    
     setupUI();
     setupMenus();
     
@@ -464,28 +470,57 @@ void MainWindow::showHelp() {
 }
 
 void MainWindow::onReactantChanged() {
+    reactantTerms_.update(reactantsEdit_->text().toStdString());
     updateEquationDisplay();
 }
 
 void MainWindow::onProductChanged() {
+    productTerms_.update(productsEdit_->text().toStdString());
     updateEquationDisplay();
 }
 
 void MainWindow::updateEquationDisplay() {
-    QString reactants = reactantsEdit_->text().trimmed();
-    QString products = productsEdit_->text().trimmed();
-    
-    if (reactants.isEmpty() || products.isEmpty()) {
+    if (reactantTerms_.empty() || productTerms_.empty()) {
         equationLabel_->setText("Ecuación actual: (incompleta)");
         statusLabel_->setText("Estado: ❌ Incompleta");
         statusLabel_->setStyleSheet("QLabel { color: red; }");
         return;
     }
     
-    QString equation = QString("%1 → %2").arg(formatEquation(reactants)).arg(formatEquation(products));
+    // Built from the cached terms, only the edited term was re-parsed
+    QString equation = QString("%1 → %2")
+                       .arg(QString::fromStdString(reactantTerms_.toDisplayString()))
+                       .arg(QString::fromStdString(productTerms_.toDisplayString()));
     equationLabel_->setText(QString("Ecuación actual: %1").arg(equation));
     
-    statusLabel_->setText("Estado: ❌ No balanceada");
+    const ParsedTerm* error = reactantTerms_.firstError();
+    if (!error) {
+        error = productTerms_.firstError();
+    }
+    if (error) {
+        statusLabel_->setText(QString("Estado: ⚠️ Término inválido \"%1\": %2")
+                              .arg(QString::fromStdString(error->text))
+                              .arg(error->diagnostic.reason));
+        statusLabel_->setStyleSheet("QLabel { color: red; }");
+        return;
+    }
+    
+    // Live balancing preview
+    ChemicalEquation preview = equationFromTerms();
+    preview.checkBalance();
+    if (preview.isBalanced()) {
+        statusLabel_->setText("Estado: ✅ Balanceada");
+        statusLabel_->setStyleSheet("QLabel { color: green; }");
+        return;
+    }
+    
+    BalanceInfo result = previewBalancer_.balance(preview);
+    if (result.result == BalanceResult::SUCCESS) {
+        statusLabel_->setText(QString("Estado: ❌ No balanceada (balanceada: %1)")
+                              .arg(QString::fromStdString(preview.toDisplayString())));
+    } else {
+        statusLabel_->setText("Estado: ❌ No balanceada");
+    }
     statusLabel_->setStyleSheet("QLabel { color: red; }");
 }
 
@@ -564,38 +599,30 @@ void MainWindow::about() {
 void MainWindow::parseInputToEquation() {
     currentEquation_.clear();
     
-    QString reactantsText = reactantsEdit_->text().trimmed();
-    QString productsText = productsEdit_->text().trimmed();
-    
-    if (reactantsText.isEmpty() || productsText.isEmpty()) {
+    if (reactantTerms_.empty() || productTerms_.empty()) {
         throw std::invalid_argument("Reactivos y productos no pueden estar vacíos");
     }
     
-    // Parse reactants
-    QStringList reactants = reactantsText.split("+", Qt::SkipEmptyParts);
-    for (const QString& reactant : reactants) {
-        QString formula = reactant.trimmed();
-        if (!formula.isEmpty()) {
-            ChemicalCompound compound(formula.toStdString());
-            if (!compound.isValid()) {
-                throw std::invalid_argument("Reactivo inválido: " + formula.toStdString());
-            }
-            currentEquation_.addReactant(compound);
-        }
+    // Terms were parsed while typing, only their compounds are collected here
+    if (const ParsedTerm* error = reactantTerms_.firstError()) {
+        throw std::invalid_argument("Reactivo inválido: " + error->text);
+    }
+    if (const ParsedTerm* error = productTerms_.firstError()) {
+        throw std::invalid_argument("Producto inválido: " + error->text);
     }
     
-    // Parse products
-    QStringList products = productsText.split("+", Qt::SkipEmptyParts);
-    for (const QString& product : products) {
-        QString formula = product.trimmed();
-        if (!formula.isEmpty()) {
-            ChemicalCompound compound(formula.toStdString());
-            if (!compound.isValid()) {
-                throw std::invalid_argument("Producto inválido: " + formula.toStdString());
-            }
-            currentEquation_.addProduct(compound);
-        }
+    currentEquation_ = equationFromTerms();
+}
+
+ChemicalEquation MainWindow::equationFromTerms() const {
+    ChemicalEquation equation;
+    for (const ParsedTerm& term : reactantTerms_.terms()) {
+        equation.addReactant(term.compound, term.coefficient);
+    }
+    for (const ParsedTerm& term : productTerms_.terms()) {
+        equation.addProduct(term.compound, term.coefficient);
     }
+    return equation;
 }
 
 void MainWindow::updateBalancedTab(const BalanceInfo& result) {
@@ -610,7 +637,7 @@ void MainWindow::updateBalancedTab(const BalanceInfo& result) {
         QString conservation;
         for (const auto& atom : result.atomBalance) {
             QString symbol = QString::fromStdString(atom.first);
-            int balance = atom.second;
+            qint64 balance = atom.second;
             QString status = (balance == 0) ? "✅" : "❌";
             conservation += QString("• %1: %2 átomos (diferencia: %3) %4\n")
                            .arg(symbol).arg("balanceado").arg(balance).arg(status);
@@ -637,7 +664,7 @@ void MainWindow::updateBalancedTab(const BalanceInfo& result) {
     }
 }
 
-void MainWindow::updateMathTab(const std::vector<SolutionStep>& mathSteps, const std::vector<std::string>& balancingSteps) {
+void MainWindow::updateMathTab(const StepJournal& mathSteps, const std::vector<std::string>& balancingSteps) {
     // Show balancing steps
     QString stepsText;
     for (size_t i = 0; i < balancingSteps.size(); ++i) {
@@ -647,14 +674,16 @@ void MainWindow::updateMathTab(const std::vector<SolutionStep>& mathSteps, const
     
     // Show matrix operations
     QString matrixText;
-    for (const auto& step : mathSteps) {
+    for (size_t i = 0; i < mathSteps.size(); ++i) {
+        // Each snapshot is rebuilt from the journal only as it is displayed
+        SolutionStep step = mathSteps.step(i);
         matrixText += QString("=== %1 ===\n").arg(QString::fromStdString(step.description));
         matrixText += QString::fromStdString(step.operation) + "\n";
         matrixText += QString::fromStdString("Matrix:\n");
         
         // Format matrix
-        for (const auto& row : step.matrix) {
-            for (double val : row) {
+        for (size_t row = 0; row < step.matrix.rows(); ++row) {
+            for (double val : step.matrix[row]) {
                 matrixText += QString("%1 ").arg(val, 8, 'f', 3);
             }
             matrixText += "\n";
@@ -27,6 +27,7 @@
 #include "StoichiometryCalculator.h"
 #include "ReactionClassifier.h"
 #include "CompoundDatabase.h"
+#include "TermCache.h"
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -53,6 +54,11 @@ private:
     StoichiometryCalculator calculator_;
     ReactionClassifier classifier_;
     
+    // Per-term parse state of the input fields, refreshed on each keystroke
+    TermCache reactantTerms_;
+    TermCache productTerms_;
+    EquationBalancer previewBalancer_; // keeps balancer_'s steps for the math tab
+    
     // Main UI components
     QWidget *centralWidget_;
     QVBoxLayout *mainLayout_;
@@ -134,7 +140,7 @@ private:
     
     void updateEquationDisplay();
     void updateBalancedTab(const BalanceInfo& result);
-    void updateMathTab(const std::vector<SolutionStep>& steps, const std::vector<std::string>& balancingSteps);
+    void updateMathTab(const StepJournal& steps, const std::vector<std::string>& balancingSteps);
     void updateChemicalTab();
     void updateStoichiometryTab();
     void updateTheoryTab();
@@ -148,6 +154,7 @@ private:
     
     std::vector<QString> getExampleEquations();
     void parseInputToEquation();
+    ChemicalEquation equationFromTerms() const;
 };
 
 #endif // MAINWINDOW_H
\ No newline at end of file
@@ -1,65 +1,301 @@
 #include "MatrixSolver.h"
+#include "CheckedArithmetic.h"
+#include "SparseEliminator.h"
+#include "BigInteger.h"
+#include "RowKernels.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
 #include <cmath>
 #include <algorithm>
+#include <limits>
+#include <stdexcept>
 
-void MatrixSolver::addStep(const std::string& description, const std::vector<std::vector<double>>& matrix, const std::string& operation) {
-    steps_.push_back({description, matrix, operation});
+MatrixSolver::MatrixSolver()
+    : sparseThreshold_(SparseEliminator<double>::DEFAULT_DENSITY_THRESHOLD), blockSize_(DEFAULT_BLOCK_SIZE),
+      threadCount_(0) {}
+
+void MatrixSolver::setSparseDensityThreshold(double threshold) {
+    sparseThreshold_ = threshold;
+}
+
+double MatrixSolver::getSparseDensityThreshold() const {
+    return sparseThreshold_;
+}
+
+void MatrixSolver::addStep(const std::string& description, const DenseMatrix<double>& matrix, const std::string& operation) {
+    if (recordSteps_) {
+        steps_.recordSnapshot(description, matrix, operation);
+    }
+}
+
+void MatrixSolver::addUnchangedStep(const std::string& description, const DenseMatrix<double>& matrix, const std::string& operation) {
+    if (!recordSteps_) {
+        return;
+    }
+    if (steps_.empty()) {
+        steps_.recordSnapshot(description, matrix, operation);
+    } else {
+        steps_.recordUnchanged(description, operation);
+    }
 }
 
-void MatrixSolver::swapRows(std::vector<std::vector<double>>& matrix, int row1, int row2) {
+void MatrixSolver::swapRows(DenseMatrix<double>& matrix, int row1, int row2) {
     if (row1 != row2) {
-        std::swap(matrix[row1], matrix[row2]);
-        addStep("Swap rows " + std::to_string(row1 + 1) + " and " + std::to_string(row2 + 1), matrix, "row_swap");
+        matrix.swapRows(row1, row2);
+        if (recordSteps_) {
+            steps_.recordSwap(row1, row2, matrix);
+        }
     }
 }
 
-void MatrixSolver::scaleRow(std::vector<std::vector<double>>& matrix, int row, double factor) {
-    for (size_t col = 0; col < matrix[row].size(); ++col) {
-        matrix[row][col] *= factor;
+void MatrixSolver::scaleRow(DenseMatrix<double>& matrix, int row, double factor) {
+    matrix.scaleRow(row, factor);
+    if (recordSteps_) {
+        steps_.recordScale(row, factor, matrix);
     }
-    std::stringstream ss;
-    ss << "Multiply row " << (row + 1) << " by " << std::fixed << std::setprecision(3) << factor;
-    addStep(ss.str(), matrix, "row_scale");
 }
 
-void MatrixSolver::addRowToRow(std::vector<std::vector<double>>& matrix, int sourceRow, int targetRow, double factor) {
-    for (size_t col = 0; col < matrix[sourceRow].size(); ++col) {
-        matrix[targetRow][col] += factor * matrix[sourceRow][col];
+void MatrixSolver::addRowToRow(DenseMatrix<double>& matrix, int sourceRow, int targetRow, double factor) {
+    // Journal replay runs the same DenseMatrix operation, so rebuilt
+    // snapshots match bit for bit
+    matrix.addScaledRow(sourceRow, targetRow, factor);
+    if (recordSteps_) {
+        steps_.recordAdd(sourceRow, targetRow, factor, matrix);
+    }
+}
+
+void MatrixSolver::addStep(const std::string& description, const DenseMatrix<int64_t>& matrix, const std::string& operation) {
+    if (recordSteps_) {
+        steps_.recordSnapshot(description, matrix, operation);
+    }
+}
+
+void MatrixSolver::addUnchangedStep(const std::string& description, const DenseMatrix<int64_t>& matrix, const std::string& operation) {
+    if (!recordSteps_) {
+        return;
+    }
+    if (steps_.empty()) {
+        steps_.recordSnapshot(description, matrix, operation);
+    } else {
+        steps_.recordUnchanged(description, operation);
     }
-    std::stringstream ss;
-    ss << "Add " << std::fixed << std::setprecision(3) << factor << " times row " 
-       << (sourceRow + 1) << " to row " << (targetRow + 1);
-    addStep(ss.str(), matrix, "row_add");
 }
 
 bool MatrixSolver::isZero(double value) const {
     return std::abs(value) < EPSILON;
 }
 
-std::vector<double> MatrixSolver::gaussianElimination(std::vector<std::vector<double>>& matrix) {
+void MatrixSolver::setBlockSize(size_t columns) {
+    blockSize_ = columns;
+}
+
+size_t MatrixSolver::getBlockSize() const {
+    return blockSize_;
+}
+
+void MatrixSolver::setThreadCount(size_t threads) {
+    threadCount_ = threads;
+}
+
+size_t MatrixSolver::getThreadCount() const {
+    return threadCount_;
+}
+
+ThreadPool& MatrixSolver::threadPool() {
+    size_t threads = threadCount_;
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    if (!pool_ || pool_->size() != threads) {
+        pool_ = std::make_shared<ThreadPool>(threads);
+    }
+    return *pool_;
+}
+
+bool MatrixSolver::usesBlockedElimination(const DenseMatrix<double>& matrix) const {
+    return blockSize_ > 0 && !recordSteps_ && matrix.rows() >= BLOCKED_MIN_ROWS && matrix.cols() >= BLOCKED_MIN_SIZE;
+}
+
+std::vector<size_t> MatrixSolver::blockedForwardElimination(DenseMatrix<double>& matrix, bool skipZeroColumns) {
+    const size_t rows = matrix.rows();
+    const size_t cols = matrix.cols();
+    const size_t lastColumn = skipZeroColumns ? cols : std::min(rows, cols);
+    ThreadPool& pool = threadPool();
+    
+    std::vector<size_t> pivotColumns;
+    size_t rank = 0; // row that takes the next pivot
+    for (size_t first = 0; first < lastColumn && rank < rows; first += blockSize_) {
+        const size_t last = std::min(first + blockSize_, lastColumn);
+        const size_t width = last - first;
+        // factors[row * width + k]: multiple of the pivot row of column
+        // first + k still to be added to row right of the panel, 0 when the
+        // row was skipped or the column has no pivot
+        panelFactors_.assign(rows * width, 0.0);
+        double* factors = panelFactors_.data();
+        panelPivotRows_.assign(width, rows);
+        
+        // The unblocked loop on the panel's columns only. The factors travel
+        // with their rows on a swap, since the deferred updates belong to them.
+        for (size_t col = first; col < last && rank < rows; ++col) {
+            size_t pivotRow = matrix.largestInColumn(col, rank);
+            if (skipZeroColumns && isZero(matrix(pivotRow, col))) {
+                continue;
+            }
+            if (pivotRow != rank) {
+                matrix.swapRows(rank, pivotRow);
+                std::swap_ranges(factors + rank * width, factors + (rank + 1) * width, factors + pivotRow * width);
+            }
+            
+            const double* source = matrix[rank].data();
+            if (isZero(source[col])) {
+                ++rank;
+                continue;
+            }
+            
+            for (size_t row = rank + 1; row < rows; ++row) {
+                double* target = matrix[row].data();
+                if (!isZero(target[col])) {
+                    double factor = -target[col] / source[col];
+                    factors[row * width + col - first] = factor;
+                    RowKernels::axpy(target + col + 1, source + col + 1, last - col - 1, factor);
+                }
+                target[col] = 0.0;
+            }
+            panelPivotRows_[col - first] = rank;
+            pivotColumns.push_back(col);
+            ++rank;
+        }
+        
+        if (last == cols) {
+            continue;
+        }
+        
+        // Panel rows right of the panel, a unit lower triangular solve. A
+        // pivot row is final before it is used, as in the unblocked loop.
+        const size_t panelEnd = rank;
+        const size_t columnTiles = (cols - last + TILE_COLUMNS - 1) / TILE_COLUMNS;
+        pool.parallelFor(columnTiles, [&](size_t tile) {
+            size_t begin = last + tile * TILE_COLUMNS;
+            size_t count = std::min(TILE_COLUMNS, cols - begin);
+            for (size_t k = 0; k < width; ++k) {
+                if (panelPivotRows_[k] == rows) {
+                    continue;
+                }
+                const double* source = matrix[panelPivotRows_[k]].data() + begin;
+                for (size_t row = panelPivotRows_[k] + 1; row < panelEnd; ++row) {
+                    double factor = factors[row * width + k];
+                    if (factor != 0.0) {
+                        RowKernels::axpy(matrix[row].data() + begin, source, count, factor);
+                    }
+                }
+            }
+        });
+        
+        // Trailing matrix: each tile takes the panel's updates in pivot order
+        if (panelEnd == rows) {
+            continue;
+        }
+        const size_t rowTiles = (rows - panelEnd + TILE_ROWS - 1) / TILE_ROWS;
+        pool.parallelFor(rowTiles * columnTiles, [&](size_t tile) {
+            size_t begin = last + (tile / rowTiles) * TILE_COLUMNS;
+            size_t count = std::min(TILE_COLUMNS, cols - begin);
+            size_t rowBegin = panelEnd + (tile % rowTiles) * TILE_ROWS;
+            size_t rowEnd = std::min(rowBegin + TILE_ROWS, rows);
+            for (size_t row = rowBegin; row < rowEnd; ++row) {
+                double* target = matrix[row].data() + begin;
+                const double* rowFactors = factors + row * width;
+                for (size_t k = 0; k < width; ++k) {
+                    if (rowFactors[k] != 0.0) {
+                        RowKernels::axpy(target, matrix[panelPivotRows_[k]].data() + begin, count, rowFactors[k]);
+                    }
+                }
+            }
+        });
+    }
+    return pivotColumns;
+}
+
+void MatrixSolver::blockedBackSubstitution(DenseMatrix<double>& matrix, const std::vector<size_t>& pivotColumns) {
+    const size_t cols = matrix.cols();
+    const size_t rank = pivotColumns.size();
+    if (rank == 0) {
+        return;
+    }
+    
+    // The pivot columns are copied first: clearing above pivot k reads
+    // column k of the rows above, which the tiles overwrite
+    pivotEntries_.resize(rank * rank);
+    for (size_t row = 0; row < rank; ++row) {
+        for (size_t k = 0; k < rank; ++k) {
+            pivotEntries_[row * rank + k] = matrix(row, pivotColumns[k]);
+        }
+    }
+    
+    // Every column tile is an independent upper triangular solve, taken a
+    // block of pivots at a time so the rows above meet the block's rows in
+    // cache. Each entry is still updated in descending pivot order.
+    const size_t columnTiles = (cols + TILE_COLUMNS - 1) / TILE_COLUMNS;
+    threadPool().parallelFor(columnTiles, [&](size_t tile) {
+        size_t begin = tile * TILE_COLUMNS;
+        size_t count = std::min(TILE_COLUMNS, cols - begin);
+        for (size_t blockEnd = rank; blockEnd > 0;) {
+            size_t blockBegin = blockEnd > blockSize_ ? blockEnd - blockSize_ : 0;
+            for (size_t k = blockEnd; k-- > blockBegin;) {
+                RowKernels::scale(matrix[k].data() + begin, count, 1.0 / pivotEntries_[k * rank + k]);
+                for (size_t row = blockBegin; row < k; ++row) {
+                    double factor = pivotEntries_[row * rank + k];
+                    if (!isZero(factor)) {
+                        RowKernels::axpy(matrix[row].data() + begin, matrix[k].data() + begin, count, -factor);
+                    }
+                }
+            }
+            for (size_t row = 0; row < blockBegin; ++row) {
+                double* target = matrix[row].data() + begin;
+                for (size_t k = blockEnd; k-- > blockBegin;) {
+                    double factor = pivotEntries_[row * rank + k];
+                    if (!isZero(factor)) {
+                        RowKernels::axpy(target, matrix[k].data() + begin, count, -factor);
+                    }
+                }
+            }
+            blockEnd = blockBegin;
+        }
+    });
+    
+    for (size_t k = 0; k < rank; ++k) {
+        for (size_t row = 0; row < rank; ++row) {
+            matrix(row, pivotColumns[k]) = row == k ? 1.0 : 0.0;
+        }
+    }
+}
+
+std::vector<double> MatrixSolver::gaussianElimination(DenseMatrix<double>& matrix) {
     steps_.clear();
     
-    if (matrix.empty() || matrix[0].empty()) {
+    if (matrix.empty()) {
         return {};
     }
     
-    int rows = matrix.size();
-    int cols = matrix[0].size();
+    if (SparseEliminator<double>::prefers(matrix, sparseThreshold_)) {
+        auto basis = sparseNullspaceBasis(matrix);
+        return basis.empty() ? std::vector<double>() : basis.back();
+    }
+    
+    int rows = matrix.rows();
+    int cols = matrix.cols();
     
     addStep("Initial matrix", matrix, "initial");
     
+    if (usesBlockedElimination(matrix)) {
+        blockedForwardElimination(matrix, false);
+        return solveHomogeneous(matrix);
+    }
+    
     // Forward elimination
     for (int pivot = 0; pivot < std::min(rows, cols); ++pivot) {
         // Find pivot row (row with largest absolute value in current column)
-        int pivotRow = pivot;
-        for (int row = pivot + 1; row < rows; ++row) {
-            if (std::abs(matrix[row][pivot]) > std::abs(matrix[pivotRow][pivot])) {
-                pivotRow = row;
-            }
-        }
+        int pivotRow = matrix.largestInColumn(pivot, pivot);
         
         // Swap rows if needed
         if (pivotRow != pivot) {
@@ -80,15 +316,15 @@ std::vector<double> MatrixSolver::gaussianElimination(std::vector<std::vector<do
         }
     }
     
-    addStep("After forward elimination", matrix, "forward_done");
+    addUnchangedStep("After forward elimination", matrix, "forward_done");
     
     // Back substitution for homogeneous system
     return solveHomogeneous(matrix);
 }
 
-std::vector<double> MatrixSolver::solveHomogeneous(std::vector<std::vector<double>>& matrix) {
-    int rows = matrix.size();
-    int cols = matrix[0].size();
+std::vector<double> MatrixSolver::solveHomogeneous(DenseMatrix<double>& matrix) {
+    int rows = matrix.rows();
+    int cols = matrix.cols();
     
     std::vector<double> solution(cols, 0.0);
     
@@ -119,52 +355,341 @@ std::vector<double> MatrixSolver::solveHomogeneous(std::vector<std::vector<doubl
         }
     }
     
-    addStep("Back substitution complete", matrix, "back_substitution");
+    addUnchangedStep("Back substitution complete", matrix, "back_substitution");
     
     return solution;
 }
 
-int MatrixSolver::rank(const std::vector<std::vector<double>>& matrix) {
+template <typename T>
+std::vector<std::vector<T>> MatrixSolver::sparseNullspaceBasis(const DenseMatrix<T>& matrix) {
+    addStep("Initial matrix", matrix, "initial");
+    
+    SparseEliminator<T> eliminator;
+    eliminator.factorize(SparseMatrix<T>(matrix));
+    if (recordSteps_) {
+        addUnchangedStep("Sparse elimination with Markowitz pivoting: rank " + std::to_string(eliminator.rank()) +
+                         ", " + std::to_string(eliminator.initialNonZeros()) + " non-zeros growing to " +
+                         std::to_string(eliminator.peakNonZeros()), matrix, "sparse_elimination");
+    }
+    
+    auto basis = eliminator.nullspaceBasis();
+    addUnchangedStep("Nullspace basis of dimension " + std::to_string(basis.size()), matrix, "nullspace");
+    
+    return basis;
+}
+
+std::vector<std::vector<double>> MatrixSolver::nullspaceBasis(DenseMatrix<double>& matrix) {
+    steps_.clear();
+    
+    if (matrix.empty()) {
+        return {};
+    }
+    
+    if (SparseEliminator<double>::prefers(matrix, sparseThreshold_)) {
+        return sparseNullspaceBasis(matrix);
+    }
+    
+    int rows = matrix.rows();
+    int cols = matrix.cols();
+    
+    addStep("Initial matrix", matrix, "initial");
+    
+    // Reduced row echelon form: every pivot is scaled to 1 and cleared both
+    // below and above, so the nullspace can be read off without back
+    // substitution
+    std::vector<int> pivotColumns;
+    if (usesBlockedElimination(matrix)) {
+        // Large systems reach the same form in two blocked passes, clearing
+        // above the pivots only once the echelon form is complete
+        std::vector<size_t> pivots = blockedForwardElimination(matrix, true);
+        blockedBackSubstitution(matrix, pivots);
+        pivotColumns.assign(pivots.begin(), pivots.end());
+    } else {
+        for (int col = 0; col < cols && static_cast<int>(pivotColumns.size()) < rows; ++col) {
+            int pivot = pivotColumns.size();
+            
+            int pivotRow = matrix.largestInColumn(col, pivot);
+            if (isZero(matrix[pivotRow][col])) {
+                continue;
+            }
+            
+            swapRows(matrix, pivot, pivotRow);
+            if (!isZero(matrix[pivot][col] - 1.0)) {
+                scaleRow(matrix, pivot, 1.0 / matrix[pivot][col]);
+            }
+            
+            for (int row = 0; row < rows; ++row) {
+                if (row != pivot && !isZero(matrix[row][col])) {
+                    addRowToRow(matrix, pivot, row, -matrix[row][col]);
+                }
+            }
+            
+            pivotColumns.push_back(col);
+        }
+    }
+    
+    addUnchangedStep("Reduced row echelon form", matrix, "rref_done");
+    
+    // One basis vector per free column: that variable is 1, the other free
+    // variables are 0 and each pivot variable is minus its row's entry
+    std::vector<std::vector<double>> basis;
+    size_t nextPivot = 0;
+    for (int col = 0; col < cols; ++col) {
+        if (nextPivot < pivotColumns.size() && pivotColumns[nextPivot] == col) {
+            ++nextPivot;
+            continue;
+        }
+        
+        std::vector<double> vector(cols, 0.0);
+        vector[col] = 1.0;
+        for (size_t k = 0; k < pivotColumns.size(); ++k) {
+            vector[pivotColumns[k]] = -matrix[k][col];
+        }
+        basis.push_back(vector);
+    }
+    
+    addUnchangedStep("Nullspace basis of dimension " + std::to_string(basis.size()), matrix, "nullspace");
+    
+    return basis;
+}
+
+std::vector<int> MatrixSolver::bareissReducedRowEchelon(DenseMatrix<int64_t>& matrix) {
+    int rows = matrix.rows();
+    int cols = matrix.cols();
+    
+    // Forward elimination. Each update is a 2x2 determinant divided by the
+    // previous pivot, which Sylvester's identity makes exact, so entries stay
+    // integers bounded by the minors of the input instead of growing
+    // exponentially as plain cross-multiplication would.
+    std::vector<int> pivotColumns;
+    int64_t previousPivot = 1;
+    for (int col = 0; col < cols && static_cast<int>(pivotColumns.size()) < rows; ++col) {
+        int pivot = pivotColumns.size();
+        
+        // Smallest non-zero entry keeps the products small
+        int pivotRow = -1;
+        for (int row = pivot; row < rows; ++row) {
+            if (matrix[row][col] != 0 &&
+                (pivotRow == -1 || std::abs(matrix[row][col]) < std::abs(matrix[pivotRow][col]))) {
+                pivotRow = row;
+            }
+        }
+        if (pivotRow == -1) {
+            continue;
+        }
+        
+        if (pivotRow != pivot) {
+            matrix.swapRows(pivot, pivotRow);
+            if (recordSteps_) {
+                steps_.recordSwap(pivot, pivotRow, matrix);
+            }
+        }
+        
+        int64_t pivotValue = matrix[pivot][col];
+        for (int row = pivot + 1; row < rows; ++row) {
+            int64_t factor = matrix[row][col];
+            for (int j = col + 1; j < cols; ++j) {
+                matrix[row][j] = checkedSubtract(checkedMultiply(pivotValue, matrix[row][j]),
+                                                 checkedMultiply(factor, matrix[pivot][j])) / previousPivot;
+            }
+            matrix[row][col] = 0;
+        }
+        
+        if (recordSteps_) {
+            steps_.recordBareissElimination(pivot, col, previousPivot, matrix);
+        }
+        
+        previousPivot = pivotValue;
+        pivotColumns.push_back(col);
+    }
+    
+    addUnchangedStep("After forward elimination", matrix, "forward_done");
+    
+    // Rows are divided by their content with the pivot made positive, which
+    // keeps the entries small while clearing above the pivots
+    auto makePrimitive = [cols](MatrixRow<int64_t> row, int pivotCol) {
+        int64_t divisor = 0;
+        for (int64_t value : row) {
+            divisor = gcd64(divisor, value);
+        }
+        if (row[pivotCol] < 0) {
+            divisor = -divisor;
+        }
+        if (divisor != 0 && divisor != 1) {
+            for (int j = 0; j < cols; ++j) {
+                row[j] /= divisor;
+            }
+        }
+    };
+    
+    int rank = pivotColumns.size();
+    for (int k = 0; k < rank; ++k) {
+        makePrimitive(matrix[k], pivotColumns[k]);
+    }
+    
+    // Working upwards, each row is already clear of the later pivot columns
+    // when it is used to clear its own column from the rows above
+    for (int k = rank - 1; k > 0; --k) {
+        int pivotCol = pivotColumns[k];
+        int64_t pivotValue = matrix[k][pivotCol];
+        bool changed = false;
+        for (int row = 0; row < k; ++row) {
+            int64_t factor = matrix[row][pivotCol];
+            if (factor == 0) {
+                continue;
+            }
+            for (int j = 0; j < cols; ++j) {
+                matrix[row][j] = checkedSubtract(checkedMultiply(pivotValue, matrix[row][j]),
+                                                 checkedMultiply(factor, matrix[k][j]));
+            }
+            makePrimitive(matrix[row], pivotColumns[row]);
+            changed = true;
+        }
+        
+        if (changed && recordSteps_) {
+            steps_.recordBareissClear(k, pivotCol, matrix);
+        }
+    }
+    
+    addStep("Reduced row echelon form (fraction-free)", matrix, "rref_done");
+    
+    return pivotColumns;
+}
+
+std::vector<std::vector<int64_t>> MatrixSolver::nullspaceBasis(DenseMatrix<int64_t>& matrix) {
+    steps_.clear();
+    
+    if (matrix.empty()) {
+        return {};
+    }
+    
+    if (SparseEliminator<int64_t>::prefers(matrix, sparseThreshold_)) {
+        return sparseNullspaceBasis(matrix);
+    }
+    
+    int cols = matrix.cols();
+    
+    addStep("Initial matrix", matrix, "initial");
+    std::vector<int> pivotColumns = bareissReducedRowEchelon(matrix);
+    
+    // Row k reads p_k * x_{c_k} + sum over free columns f of a_kf * x_f = 0,
+    // so setting one free variable to the lcm of the reduced pivots keeps
+    // every pivot variable integral
+    std::vector<std::vector<int64_t>> basis;
+    size_t nextPivot = 0;
+    for (int col = 0; col < cols; ++col) {
+        if (nextPivot < pivotColumns.size() && pivotColumns[nextPivot] == col) {
+            ++nextPivot;
+            continue;
+        }
+        
+        int64_t scale = 1;
+        for (size_t k = 0; k < pivotColumns.size(); ++k) {
+            int64_t entry = matrix[k][col];
+            if (entry != 0) {
+                int64_t denominator = matrix[k][pivotColumns[k]] / gcd64(entry, matrix[k][pivotColumns[k]]);
+                scale = checkedMultiply(scale / gcd64(scale, denominator), denominator);
+            }
+        }
+        
+        std::vector<int64_t> vector(cols, 0);
+        vector[col] = scale;
+        for (size_t k = 0; k < pivotColumns.size(); ++k) {
+            int64_t entry = matrix[k][col];
+            if (entry != 0) {
+                int64_t pivotValue = matrix[k][pivotColumns[k]];
+                int64_t divisor = gcd64(entry, pivotValue);
+                vector[pivotColumns[k]] = -checkedMultiply(entry / divisor, scale / (pivotValue / divisor));
+            }
+        }
+        
+        int64_t divisor = 0;
+        for (int64_t value : vector) {
+            divisor = gcd64(divisor, value);
+        }
+        if (divisor > 1) {
+            for (int64_t& value : vector) {
+                value /= divisor;
+            }
+        }
+        basis.push_back(vector);
+    }
+    
+    addUnchangedStep("Nullspace basis of dimension " + std::to_string(basis.size()), matrix, "nullspace");
+    
+    return basis;
+}
+
+std::vector<int64_t> MatrixSolver::bareissElimination(DenseMatrix<int64_t>& matrix) {
+    auto basis = nullspaceBasis(matrix);
+    if (basis.empty()) {
+        return {};
+    }
+    
+    // The basis vector of the last free column, like solveHomogeneous pins
+    // the last variable; any other free variables stay zero
+    return basis.back();
+}
+
+int MatrixSolver::rank(const DenseMatrix<double>& matrix) {
     if (matrix.empty()) return 0;
     
-    auto tempMatrix = matrix;
-    gaussianElimination(tempMatrix);
+    // Copy-assignment reuses the scratch buffer once it has grown to the
+    // largest matrix seen, so repeated pre-checks do not allocate
+    scratch_ = matrix;
+    int rows = scratch_.rows();
+    int cols = scratch_.cols();
     
+    // Forward elimination only, pivoting by column: no steps, no back
+    // substitution, and steps_ is left as the last explained solve had it
     int rank = 0;
-    for (const auto& row : tempMatrix) {
-        bool hasNonZero = false;
-        for (double val : row) {
-            if (!isZero(val)) {
-                hasNonZero = true;
-                break;
+    for (int col = 0; col < cols && rank < rows; ++col) {
+        int pivotRow = scratch_.largestInColumn(col, rank);
+        if (isZero(scratch_(pivotRow, col))) {
+            continue;
+        }
+        
+        scratch_.swapRows(rank, pivotRow);
+        for (int row = rank + 1; row < rows; ++row) {
+            if (!isZero(scratch_(row, col))) {
+                scratch_.addScaledRow(rank, row, -scratch_(row, col) / scratch_(rank, col));
             }
         }
-        if (hasNonZero) rank++;
+        ++rank;
     }
     
     return rank;
 }
 
-bool MatrixSolver::hasUniqueSolution(const std::vector<std::vector<double>>& matrix) {
+int MatrixSolver::nullity(const DenseMatrix<double>& matrix) {
+    return static_cast<int>(matrix.cols()) - rank(matrix);
+}
+
+bool MatrixSolver::hasUniqueSolution(const DenseMatrix<double>& matrix) {
     if (matrix.empty()) return false;
     
-    int matrixRank = rank(matrix);
-    int numVars = matrix[0].size();
-    
-    return matrixRank == numVars - 1;
+    return nullity(matrix) == 1;
 }
 
-std::vector<SolutionStep> MatrixSolver::getSteps() const {
+const StepJournal& MatrixSolver::getSteps() const {
     return steps_;
 }
 
+void MatrixSolver::setRecordSteps(bool record) {
+    recordSteps_ = record;
+}
+
+bool MatrixSolver::isRecordingSteps() const {
+    return recordSteps_;
+}
+
 void MatrixSolver::clearSteps() {
     steps_.clear();
 }
 
-void MatrixSolver::printMatrix(const std::vector<std::vector<double>>& matrix) const {
-    for (const auto& row : matrix) {
-        for (double val : row) {
+void MatrixSolver::printMatrix(const DenseMatrix<double>& matrix) const {
+    for (size_t row = 0; row < matrix.rows(); ++row) {
+        for (double val : matrix[row]) {
             std::cout << std::fixed << std::setprecision(3) << std::setw(8) << val << " ";
         }
         std::cout << std::endl;
@@ -172,26 +697,82 @@ void MatrixSolver::printMatrix(const std::vector<std::vector<double>>& matrix) c
     std::cout << std::endl;
 }
 
-std::string MatrixSolver::matrixToString(const std::vector<std::vector<double>>& matrix) const {
+std::string MatrixSolver::matrixToString(const DenseMatrix<double>& matrix) const {
     std::stringstream ss;
-    for (const auto& row : matrix) {
-        for (size_t i = 0; i < row.size(); ++i) {
-            if (i > 0) ss << "  ";
-            ss << std::fixed << std::setprecision(3) << std::setw(8) << row[i];
+    for (size_t row = 0; row < matrix.rows(); ++row) {
+        for (size_t col = 0; col < matrix.cols(); ++col) {
+            if (col > 0) ss << "  ";
+            ss << std::fixed << std::setprecision(3) << std::setw(8) << matrix(row, col);
         }
         ss << "\n";
     }
     return ss.str();
 }
 
-std::vector<int> MatrixSolver::reduceToIntegers(const std::vector<double>& coefficients) {
-    std::vector<int> result;
+#ifdef CHECKED_ARITHMETIC_INT128
+// Common denominator and scaled numerators in 128 bits; false when an
+// intermediate overflows even there
+static bool scaleToIntegers128(const std::vector<int64_t>& numerators, const std::vector<int64_t>& denominators,
+                               std::vector<int64_t>& result) {
+    int128 common = 1;
+    for (int64_t denominator : denominators) {
+        if (multiplyOverflows128(common / gcd128(common, denominator), denominator, common)) {
+            return false;
+        }
+    }
+    
+    std::vector<int128> scaled(numerators.size());
+    int128 divisor = 0;
+    for (size_t i = 0; i < numerators.size(); ++i) {
+        if (multiplyOverflows128(numerators[i], common / denominators[i], scaled[i])) {
+            return false;
+        }
+        divisor = gcd128(divisor, scaled[i]);
+    }
+    
+    result.clear();
+    for (int128 value : scaled) {
+        value = divisor > 1 ? value / divisor : value;
+        if (!fitsInt64(value)) {
+            throwIntegerOverflow();
+        }
+        result.push_back(static_cast<int64_t>(value));
+    }
+    return true;
+}
+#endif
+
+static void scaleToIntegersBig(const std::vector<int64_t>& numerators, const std::vector<int64_t>& denominators,
+                               std::vector<int64_t>& result) {
+    BigInteger common = 1;
+    for (int64_t denominator : denominators) {
+        common = common / BigInteger::gcd(common, denominator) * BigInteger(denominator);
+    }
+    
+    std::vector<BigInteger> scaled;
+    BigInteger divisor;
+    for (size_t i = 0; i < numerators.size(); ++i) {
+        scaled.push_back(BigInteger(numerators[i]) * (common / BigInteger(denominators[i])));
+        divisor = BigInteger::gcd(divisor, scaled.back());
+    }
+    
+    // toInt64 throws std::overflow_error for a coefficient beyond 64 bits
+    result.clear();
+    for (const BigInteger& value : scaled) {
+        result.push_back((divisor > BigInteger(1) ? value / divisor : value).toInt64());
+    }
+}
+
+std::vector<int64_t> MatrixSolver::reduceToIntegers(const std::vector<double>& coefficients) {
+    std::vector<int64_t> result;
     
     // Find denominators by converting to fractions
-    std::vector<int> numerators;
-    std::vector<int> denominators;
+    std::vector<int64_t> numerators;
+    std::vector<int64_t> denominators;
     
     const double TOLERANCE = 1e-6;
+    // Keeps llround exact and inside 64 bits
+    const double NUMERATOR_LIMIT = 4e18;
     
     for (double coef : coefficients) {
         // Find a reasonable fraction representation
@@ -199,7 +780,7 @@ std::vector<int> MatrixSolver::reduceToIntegers(const std::vector<double>& coeff
         for (int denom = 1; denom <= 1000 && !found; ++denom) {
             double num = coef * denom;
             if (std::abs(num - std::round(num)) < TOLERANCE) {
-                numerators.push_back(static_cast<int>(std::round(num)));
+                numerators.push_back(std::llround(num));
                 denominators.push_back(denom);
                 found = true;
             }
@@ -207,37 +788,26 @@ std::vector<int> MatrixSolver::reduceToIntegers(const std::vector<double>& coeff
         
         if (!found) {
             // Fallback: multiply by 1000 and round
-            numerators.push_back(static_cast<int>(std::round(coef * 1000)));
+            numerators.push_back(std::llround(coef * 1000));
             denominators.push_back(1000);
         }
+        
+        if (!(std::abs(coef * denominators.back()) < NUMERATOR_LIMIT)) {
+            throw std::overflow_error("Coefficient exceeds the supported range");
+        }
     }
     
-    // Find LCM of all denominators
-    int lcmValue = denominators[0];
-    for (size_t i = 1; i < denominators.size(); ++i) {
-        lcmValue = lcm(lcmValue, denominators[i]);
-    }
-    
-    // Convert to integers
-    for (size_t i = 0; i < numerators.size(); ++i) {
-        result.push_back(numerators[i] * lcmValue / denominators[i]);
-    }
-    
-    // Find GCD and reduce
-    int gcdValue = std::abs(result[0]);
-    for (size_t i = 1; i < result.size(); ++i) {
-        gcdValue = gcd(gcdValue, std::abs(result[i]));
-    }
-    
-    if (gcdValue > 1) {
-        for (int& val : result) {
-            val /= gcdValue;
-        }
+    // Scale by the LCM of all denominators, then divide out the common factor
+#ifdef CHECKED_ARITHMETIC_INT128
+    if (!scaleToIntegers128(numerators, denominators, result))
+#endif
+    {
+        scaleToIntegersBig(numerators, denominators, result);
     }
     
     // Make sure all coefficients are positive
     bool allNegative = true;
-    for (int val : result) {
+    for (int64_t val : result) {
         if (val > 0) {
             allNegative = false;
             break;
@@ -245,7 +815,7 @@ std::vector<int> MatrixSolver::reduceToIntegers(const std::vector<double>& coeff
     }
     
     if (allNegative) {
-        for (int& val : result) {
+        for (int64_t& val : result) {
             val = -val;
         }
     }
@@ -253,18 +823,10 @@ std::vector<int> MatrixSolver::reduceToIntegers(const std::vector<double>& coeff
     return result;
 }
 
-int MatrixSolver::gcd(int a, int b) {
-    a = std::abs(a);
-    b = std::abs(b);
-    
-    while (b != 0) {
-        int temp = b;
-        b = a % b;
-        a = temp;
-    }
-    return a;
+int64_t MatrixSolver::gcd(int64_t a, int64_t b) {
+    return gcd64(a, b);
 }
 
-int MatrixSolver::lcm(int a, int b) {
-    return std::abs(a * b) / gcd(a, b);
+int64_t MatrixSolver::lcm(int64_t a, int64_t b) {
+    return checkedLcm(a, b);
 }
\ No newline at end of file
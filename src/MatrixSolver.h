@@ -1,42 +1,148 @@
 #ifndef MATRIX_SOLVER_H
 #define MATRIX_SOLVER_H
 
+#include "DenseMatrix.h"
+#include "StepJournal.h"
+#include "ThreadPool.h"
 #include <vector>
 #include <string>
+#include <memory>
+#include <cstdint>
 
-struct SolutionStep {
-    std::string description;
-    std::vector<std::vector<double>> matrix;
-    std::string operation;
+enum class SolverMode {
+    FLOATING_POINT,  // partial pivoting in double, then reduceToIntegers
+    EXACT_INTEGER,   // fraction-free Bareiss elimination over 64-bit integers
+    MIXED_PRECISION  // float, then double, kept only if verified exactly; else EXACT_INTEGER
 };
 
 class MatrixSolver {
+public:
+    // Pivot columns per panel of the blocked elimination
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 32;
+    // Smaller systems always take the unblocked loop. Stoichiometric
+    // matrices have one row per element, so the row bound stays below the
+    // size of the periodic table.
+    static constexpr size_t BLOCKED_MIN_ROWS = 64;
+    static constexpr size_t BLOCKED_MIN_SIZE = 128;
+    // Trailing-matrix tile: 64 rows of 256 doubles, next to the panel's own
+    // 256-column strip, stays in L2 while the panel's updates are applied
+    static constexpr size_t TILE_ROWS = 64;
+    static constexpr size_t TILE_COLUMNS = 256;
+
 private:
-    std::vector<SolutionStep> steps_;
+    StepJournal steps_;
+    DenseMatrix<double> scratch_; // working copy for rank(), kept between calls
+    double sparseThreshold_;
+    bool recordSteps_ = true;
     const double EPSILON = 1e-10;
+    size_t blockSize_;
+    size_t threadCount_;
+    std::shared_ptr<ThreadPool> pool_; // created on first blocked elimination
+    std::vector<double> panelFactors_; // rows x block multipliers, reused
+    std::vector<size_t> panelPivotRows_; // pivot row per panel column, rows if none
+    std::vector<double> pivotEntries_; // rank x rank pivot columns for back substitution
     
-    void addStep(const std::string& description, const std::vector<std::vector<double>>& matrix, const std::string& operation = "");
-    void swapRows(std::vector<std::vector<double>>& matrix, int row1, int row2);
-    void scaleRow(std::vector<std::vector<double>>& matrix, int row, double factor);
-    void addRowToRow(std::vector<std::vector<double>>& matrix, int sourceRow, int targetRow, double factor);
+    void addStep(const std::string& description, const DenseMatrix<double>& matrix, const std::string& operation = "");
+    // For steps that only annotate the current matrix; the journal stores no
+    // copy unless the step is the first one
+    void addUnchangedStep(const std::string& description, const DenseMatrix<double>& matrix, const std::string& operation);
+    void swapRows(DenseMatrix<double>& matrix, int row1, int row2);
+    void scaleRow(DenseMatrix<double>& matrix, int row, double factor);
+    void addRowToRow(DenseMatrix<double>& matrix, int sourceRow, int targetRow, double factor);
     bool isZero(double value) const;
     
+    ThreadPool& threadPool();
+    bool usesBlockedElimination(const DenseMatrix<double>& matrix) const;
+    // Forward elimination in column panels: the panel is reduced with the
+    // usual partial pivoting, and its updates are then applied to the rest
+    // of the matrix tile by tile on the pool. A column without a pivot
+    // still uses up a row, as in gaussianElimination, unless
+    // skipZeroColumns, which leaves the row echelon form nullspaceBasis
+    // needs. Returns the pivot columns.
+    std::vector<size_t> blockedForwardElimination(DenseMatrix<double>& matrix, bool skipZeroColumns);
+    // Scales the pivots of a row echelon form to 1 and clears above them,
+    // solving each column tile on the pool, which leaves the RREF
+    void blockedBackSubstitution(DenseMatrix<double>& matrix, const std::vector<size_t>& pivotColumns);
+    
+    // Markowitz-ordered SparseEliminator run behind the dense entry points;
+    // records the initial matrix and a summary instead of row operations
+    template <typename T>
+    std::vector<std::vector<T>> sparseNullspaceBasis(const DenseMatrix<T>& matrix);
+    
+    void addStep(const std::string& description, const DenseMatrix<int64_t>& matrix, const std::string& operation);
+    void addUnchangedStep(const std::string& description, const DenseMatrix<int64_t>& matrix, const std::string& operation);
+    // Fraction-free reduction to row echelon form with every row primitive
+    // and cleared above its pivot; returns the pivot column of each row
+    std::vector<int> bareissReducedRowEchelon(DenseMatrix<int64_t>& matrix);
+    
 public:
-    std::vector<double> gaussianElimination(std::vector<std::vector<double>>& matrix);
-    std::vector<double> solveHomogeneous(std::vector<std::vector<double>>& matrix);
+    MatrixSolver();
+    
+    // gaussianElimination and nullspaceBasis hand systems with at least
+    // SparseEliminator::MIN_COLUMNS columns and a density below this to the
+    // sparse engine, leaving the matrix unreduced; 0 keeps everything dense
+    void setSparseDensityThreshold(double threshold);
+    double getSparseDensityThreshold() const;
     
-    int rank(const std::vector<std::vector<double>>& matrix);
-    bool hasUniqueSolution(const std::vector<std::vector<double>>& matrix);
+    // Without step recording, systems of at least BLOCKED_MIN_ROWS rows and
+    // BLOCKED_MIN_SIZE columns are eliminated in panels of this many
+    // columns, updating the trailing matrix on setThreadCount threads. Each
+    // entry still receives the same updates in the same order as the
+    // unblocked loop, so the result does not depend on the thread count or
+    // the block size. nullspaceBasis then clears above the pivots in a
+    // second pass instead of during elimination, which rounds differently
+    // from its unblocked loop. 0 turns blocking off.
+    void setBlockSize(size_t columns);
+    size_t getBlockSize() const;
+    // Threads for the blocked elimination, counting the caller; 0 uses
+    // std::thread::hardware_concurrency()
+    void setThreadCount(size_t threads);
+    size_t getThreadCount() const;
     
-    std::vector<SolutionStep> getSteps() const;
+    std::vector<double> gaussianElimination(DenseMatrix<double>& matrix);
+    std::vector<double> solveHomogeneous(DenseMatrix<double>& matrix);
+    
+    // Complete nullspace from a single RREF pass: one vector per free column,
+    // with that variable set to 1 and the other free variables to 0. Empty
+    // when only the zero vector solves the system.
+    std::vector<std::vector<double>> nullspaceBasis(DenseMatrix<double>& matrix);
+    
+    // Exact counterpart: one primitive integer vector per free column, with
+    // the free variable positive. Throws std::overflow_error when an
+    // intermediate value does not fit in 64 bits.
+    std::vector<std::vector<int64_t>> nullspaceBasis(DenseMatrix<int64_t>& matrix);
+    
+    // Exact counterpart of gaussianElimination + reduceToIntegers: the basis
+    // vector of the last free column, matching the free variable choice of
+    // solveHomogeneous, or an empty vector when there is none
+    std::vector<int64_t> bareissElimination(DenseMatrix<int64_t>& matrix);
+    
+    // Cheap pre-checks: forward elimination in a reused scratch buffer, with
+    // no step recording and no effect on getSteps()
+    int rank(const DenseMatrix<double>& matrix);
+    int nullity(const DenseMatrix<double>& matrix);
+    bool hasUniqueSolution(const DenseMatrix<double>& matrix);
+    
+    // Matrices are rebuilt per step on request, see StepJournal
+    const StepJournal& getSteps() const;
     void clearSteps();
     
-    void printMatrix(const std::vector<std::vector<double>>& matrix) const;
-    std::string matrixToString(const std::vector<std::vector<double>>& matrix) const;
+    // Every row operation is normally journaled for the GUI's math tab. Turned off, nothing is recorded
+    // and getSteps() stays empty, which is the fast mode for large systems.
+    void setRecordSteps(bool record);
+    bool isRecordingSteps() const;
+    
+    void printMatrix(const DenseMatrix<double>& matrix) const;
+    std::string matrixToString(const DenseMatrix<double>& matrix) const;
     
-    std::vector<int> reduceToIntegers(const std::vector<double>& coefficients);
-    int gcd(int a, int b);
-    int lcm(int a, int b);
+    // Smallest integer multiple of a floating-point solution. The common
+    // denominator is built in 128 bits and only redone with BigInteger when
+    // that overflows; throws std::overflow_error when a reduced coefficient
+    // does not fit in 64 bits.
+    std::vector<int64_t> reduceToIntegers(const std::vector<double>& coefficients);
+    int64_t gcd(int64_t a, int64_t b);
+    // Throws std::overflow_error instead of wrapping
+    int64_t lcm(int64_t a, int64_t b);
 };
 
 #endif // MATRIX_SOLVER_H
\ No newline at end of file
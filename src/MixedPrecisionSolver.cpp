@@ -0,0 +1,251 @@
+#include "MixedPrecisionSolver.h"
+#include "CheckedArithmetic.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+template <typename T>
+struct PrecisionTraits;
+
+// Tolerances are relative: pivots to the largest matrix entry, fractions to
+// the value rounded. A looser choice only costs a failed verification.
+template <>
+struct PrecisionTraits<float> {
+    static constexpr double EXACT_LIMIT = 16777216.0; // 2^24
+    static constexpr double PIVOT_TOLERANCE = 1e-4;
+    static constexpr double FRACTION_TOLERANCE = 1e-4;
+    static constexpr int64_t MAX_DENOMINATOR = 1 << 12;
+};
+
+template <>
+struct PrecisionTraits<double> {
+    static constexpr double EXACT_LIMIT = 9007199254740992.0; // 2^53
+    static constexpr double PIVOT_TOLERANCE = 1e-10;
+    static constexpr double FRACTION_TOLERANCE = 1e-9;
+    static constexpr int64_t MAX_DENOMINATOR = int64_t(1) << 30;
+};
+
+}
+
+// Prime for the rank certificate: products of two residues fit in 64 bits
+static const int64_t CERTIFICATE_PRIME = 2147483647; // 2^31 - 1
+
+static int64_t inverseMod(int64_t value, int64_t p) {
+    // Extended Euclid; value is nonzero and p prime
+    int64_t a = value, b = p, x = 1, y = 0;
+    while (b != 0) {
+        int64_t q = a / b;
+        int64_t remainder = a - q * b;
+        a = b;
+        b = remainder;
+        int64_t next = x - q * y;
+        x = y;
+        y = next;
+    }
+    return x < 0 ? x + p : x;
+}
+
+// First continued-fraction convergent p/q of value within tolerance; false
+// when the denominator would pass maxDenominator first
+static bool nearestFraction(double value, double tolerance, int64_t maxDenominator,
+                            int64_t& numerator, int64_t& denominator) {
+    // Convergents h/k from h = a * h' + h'', starting at 1/0 and 0/1
+    int64_t previousNumerator = 0, previousDenominator = 1;
+    numerator = 1;
+    denominator = 0;
+    double remainder = value;
+    for (int term = 0; term < 64; ++term) {
+        double whole = std::floor(remainder);
+        if (std::abs(whole) >= 4611686018427387904.0) { // 2^62
+            return false;
+        }
+        int64_t a = static_cast<int64_t>(whole);
+        int64_t nextNumerator = checkedAdd(checkedMultiply(a, numerator), previousNumerator);
+        int64_t nextDenominator = checkedAdd(checkedMultiply(a, denominator), previousDenominator);
+        if (nextDenominator > maxDenominator) {
+            return false;
+        }
+        previousNumerator = numerator;
+        previousDenominator = denominator;
+        numerator = nextNumerator;
+        denominator = nextDenominator;
+
+        double fraction = remainder - whole;
+        if (fraction == 0.0 || std::abs(value - static_cast<double>(numerator) / denominator) <= tolerance) {
+            return true;
+        }
+        remainder = 1.0 / fraction;
+    }
+    return false;
+}
+
+MixedPrecisionSolver::MixedPrecisionSolver() : precision_(FloatPrecision::NONE) {}
+
+template <typename T>
+bool MixedPrecisionSolver::solveIn(const DenseMatrix<int64_t>& matrix, DenseMatrix<T>& work,
+                                   std::vector<std::vector<int64_t>>& basis) {
+    using Traits = PrecisionTraits<T>;
+    const size_t rows = matrix.rows();
+    const size_t cols = matrix.cols();
+
+    // Entries must convert exactly, or the float system is a different one
+    double largest = 0.0;
+    work.assign(rows, cols, T(0));
+    for (size_t i = 0; i < rows * cols; ++i) {
+        double value = static_cast<double>(matrix.data()[i]);
+        if (std::abs(value) >= Traits::EXACT_LIMIT) {
+            return false;
+        }
+        largest = std::max(largest, std::abs(value));
+        work.data()[i] = static_cast<T>(value);
+    }
+    const double pivotTolerance = Traits::PIVOT_TOLERANCE * largest;
+
+    // Gauss-Jordan with partial pivoting, pivots scaled to 1
+    std::vector<size_t> rowOrder(rows);
+    for (size_t row = 0; row < rows; ++row) {
+        rowOrder[row] = row;
+    }
+    pivotRows_.clear();
+    pivotColumns_.clear();
+    for (size_t col = 0; col < cols && pivotColumns_.size() < rows; ++col) {
+        size_t rank = pivotColumns_.size();
+        size_t best = work.largestInColumn(col, rank);
+        if (std::abs(static_cast<double>(work(best, col))) <= pivotTolerance) {
+            continue;
+        }
+        work.swapRows(rank, best);
+        std::swap(rowOrder[rank], rowOrder[best]);
+
+        work.scaleRow(rank, T(1) / work(rank, col));
+        work(rank, col) = T(1);
+        for (size_t row = 0; row < rows; ++row) {
+            if (row != rank && work(row, col) != T(0)) {
+                work.addScaledRow(rank, row, -work(row, col));
+                work(row, col) = T(0);
+            }
+        }
+        pivotRows_.push_back(rowOrder[rank]);
+        pivotColumns_.push_back(col);
+    }
+
+    if (!certifyRank(matrix)) {
+        return false;
+    }
+
+    basis.clear();
+    std::vector<int64_t> numerators(pivotColumns_.size());
+    std::vector<int64_t> denominators(pivotColumns_.size());
+    size_t nextPivot = 0;
+    for (size_t col = 0; col < cols; ++col) {
+        if (nextPivot < pivotColumns_.size() && pivotColumns_[nextPivot] == col) {
+            ++nextPivot;
+            continue;
+        }
+
+        // x_col = 1 and x_c = -work(k, col) for the pivots c left of col;
+        // entries of later pivots belong to no exact basis vector
+        int64_t scale = 1;
+        for (size_t k = 0; k < nextPivot; ++k) {
+            double value = -static_cast<double>(work(k, col));
+            double tolerance = Traits::FRACTION_TOLERANCE * std::max(1.0, std::abs(value));
+            if (!nearestFraction(value, tolerance, Traits::MAX_DENOMINATOR, numerators[k], denominators[k])) {
+                return false;
+            }
+            scale = checkedLcm(scale, denominators[k]);
+        }
+
+        std::vector<int64_t> vector(cols, 0);
+        vector[col] = scale;
+        int64_t divisor = scale;
+        for (size_t k = 0; k < nextPivot; ++k) {
+            vector[pivotColumns_[k]] = checkedMultiply(numerators[k], scale / denominators[k]);
+            divisor = gcd64(divisor, vector[pivotColumns_[k]]);
+        }
+        for (int64_t& value : vector) {
+            value /= divisor;
+        }
+
+        for (size_t row = 0; row < rows; ++row) {
+            int64_t sum = 0;
+            for (size_t k = 0; k < cols; ++k) {
+                if (vector[k] != 0) {
+                    sum = checkedAdd(sum, checkedMultiply(matrix(row, k), vector[k]));
+                }
+            }
+            if (sum != 0) {
+                return false;
+            }
+        }
+        basis.push_back(std::move(vector));
+    }
+    return true;
+}
+
+bool MixedPrecisionSolver::certifyRank(const DenseMatrix<int64_t>& matrix) {
+    // A nonzero determinant modulo p is nonzero over the integers; a minor
+    // that p happens to divide only fails the certificate
+    const int64_t p = CERTIFICATE_PRIME;
+    const size_t rank = pivotColumns_.size();
+    minor_.resize(rank * rank);
+    for (size_t i = 0; i < rank; ++i) {
+        for (size_t j = 0; j < rank; ++j) {
+            int64_t value = matrix(pivotRows_[i], pivotColumns_[j]) % p;
+            minor_[i * rank + j] = value < 0 ? value + p : value;
+        }
+    }
+
+    for (size_t col = 0; col < rank; ++col) {
+        size_t pivot = col;
+        while (pivot < rank && minor_[pivot * rank + col] == 0) {
+            ++pivot;
+        }
+        if (pivot == rank) {
+            return false;
+        }
+        std::swap_ranges(minor_.begin() + pivot * rank, minor_.begin() + (pivot + 1) * rank, minor_.begin() + col * rank);
+        
+        int64_t inverse = inverseMod(minor_[col * rank + col], p);
+        for (size_t row = col + 1; row < rank; ++row) {
+            int64_t factor = minor_[row * rank + col] * inverse % p;
+            if (factor == 0) {
+                continue;
+            }
+            for (size_t k = col; k < rank; ++k) {
+                int64_t& target = minor_[row * rank + k];
+                target = (target - factor * minor_[col * rank + k] % p + p) % p;
+            }
+        }
+    }
+    return true;
+}
+
+bool MixedPrecisionSolver::nullspaceBasis(const DenseMatrix<int64_t>& matrix, std::vector<std::vector<int64_t>>& basis) {
+    precision_ = FloatPrecision::NONE;
+    basis.clear();
+    if (matrix.empty()) {
+        return false;
+    }
+
+    // Overflow in the rounding or the check only means this precision
+    // cannot prove its answer
+    try {
+        if (solveIn(matrix, single_, basis)) {
+            precision_ = FloatPrecision::SINGLE;
+            return true;
+        }
+    } catch (const std::overflow_error&) {
+    }
+    try {
+        if (solveIn(matrix, double_, basis)) {
+            precision_ = FloatPrecision::DOUBLE;
+            return true;
+        }
+    } catch (const std::overflow_error&) {
+    }
+
+    basis.clear();
+    return false;
+}
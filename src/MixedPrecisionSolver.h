@@ -0,0 +1,54 @@
+#ifndef MIXED_PRECISION_SOLVER_H
+#define MIXED_PRECISION_SOLVER_H
+
+#include "DenseMatrix.h"
+#include <vector>
+#include <cstdint>
+
+enum class FloatPrecision {
+    NONE,   // no floating-point basis passed verification
+    SINGLE,
+    DOUBLE
+};
+
+// Integer nullspace at floating-point speed, accepted only once proven
+// exact. The matrix is reduced to RREF in float, and again in double when
+// that fails. Each basis vector is rounded to fractions with small
+// denominators by continued fractions and scaled to a primitive integer
+// vector, which must then pass two exact checks:
+//
+// 1. A v = 0 by a checked integer matrix-vector product.
+// 2. The pivot minor is nonzero modulo a 31-bit prime. This proves the
+//    rank, so the verified vectors are the whole basis and not part of it.
+//
+// Vectors only use pivots left of their free column, so together the
+// checks also prove the pivot columns are those of the exact RREF. A
+// verified basis is therefore exactly MatrixSolver::nullspaceBasis's on
+// int64_t, and nothing rounded wrongly is ever returned.
+class MixedPrecisionSolver {
+private:
+    DenseMatrix<float> single_;
+    DenseMatrix<double> double_;
+    std::vector<size_t> pivotRows_;    // original row of each pivot
+    std::vector<size_t> pivotColumns_;
+    std::vector<int64_t> minor_;       // pivot minor modulo a prime, reused
+    FloatPrecision precision_;
+
+    template <typename T>
+    bool solveIn(const DenseMatrix<int64_t>& matrix, DenseMatrix<T>& work, std::vector<std::vector<int64_t>>& basis);
+    bool certifyRank(const DenseMatrix<int64_t>& matrix);
+
+public:
+    MixedPrecisionSolver();
+
+    // One primitive vector per free column, with that column positive and
+    // the other free columns zero. False, with basis empty, when neither
+    // precision yields a basis that verifies; the caller then needs an
+    // exact solver.
+    bool nullspaceBasis(const DenseMatrix<int64_t>& matrix, std::vector<std::vector<int64_t>>& basis);
+
+    // Precision whose basis the last call returned
+    FloatPrecision precision() const { return precision_; }
+};
+
+#endif // MIXED_PRECISION_SOLVER_H
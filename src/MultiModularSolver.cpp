@@ -0,0 +1,375 @@
+#include "MultiModularSolver.h"
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+using uint128 = unsigned __int128;
+
+static uint64_t mulMod(uint64_t a, uint64_t b, uint64_t p) {
+    return static_cast<uint64_t>(static_cast<uint128>(a) * b % p);
+}
+
+static uint64_t addMod(uint64_t a, uint64_t b, uint64_t p) {
+    uint64_t sum = a + b;
+    return sum >= p ? sum - p : sum;
+}
+
+static uint64_t powMod(uint64_t base, uint64_t exponent, uint64_t p) {
+    uint64_t result = 1;
+    for (base %= p; exponent != 0; exponent >>= 1) {
+        if (exponent & 1) {
+            result = mulMod(result, base, p);
+        }
+        base = mulMod(base, base, p);
+    }
+    return result;
+}
+
+static uint64_t inverseMod(uint64_t value, uint64_t p) {
+    return powMod(value, p - 2, p);
+}
+
+namespace {
+
+// A factor with its precomputed quotient floor(factor * 2^64 / p) (Shoup):
+// multiplying by it takes two multiplications and no division, which is
+// what keeps row operations modulo a 62-bit prime cheap
+struct ShoupFactor {
+    uint64_t value;
+    uint64_t quotient;
+
+    ShoupFactor(uint64_t factor, uint64_t p)
+        : value(factor), quotient(static_cast<uint64_t>((static_cast<uint128>(factor) << 64) / p)) {}
+
+    uint64_t multiply(uint64_t a, uint64_t p) const {
+        uint64_t estimate = static_cast<uint64_t>((static_cast<uint128>(a) * quotient) >> 64);
+        uint64_t result = a * value - estimate * p;
+        return result >= p ? result - p : result;
+    }
+};
+
+// Reduced row echelon form of the matrix modulo one prime
+struct ModularImage {
+    uint64_t prime = 0;
+    std::vector<int> pivotColumns;
+    std::vector<int> freeColumns;
+    std::vector<uint64_t> entries; // pivot row k, free column i at k * freeColumns.size() + i
+};
+
+}
+
+// Deterministic Miller-Rabin: these bases decide every 64-bit integer
+static bool isPrime(uint64_t n) {
+    if (n < 2) {
+        return false;
+    }
+    static const uint64_t BASES[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+    for (uint64_t base : BASES) {
+        if (n % base == 0) {
+            return n == base;
+        }
+    }
+
+    uint64_t odd = n - 1;
+    int twos = 0;
+    while ((odd & 1) == 0) {
+        odd >>= 1;
+        ++twos;
+    }
+    for (uint64_t base : BASES) {
+        uint64_t x = powMod(base, odd, n);
+        if (x == 1 || x == n - 1) {
+            continue;
+        }
+        bool composite = true;
+        for (int i = 1; i < twos && composite; ++i) {
+            x = mulMod(x, x, n);
+            composite = x != n - 1;
+        }
+        if (composite) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t MultiModularSolver::prime(size_t index) {
+    static std::mutex mutex;
+    static std::vector<uint64_t> primes;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t candidate = primes.empty() ? (uint64_t(1) << 62) - 1 : primes.back() - 2;
+    while (primes.size() <= index) {
+        while (!isPrime(candidate)) {
+            candidate -= 2;
+        }
+        primes.push_back(candidate);
+        candidate -= 2;
+    }
+    return primes[index];
+}
+
+static ModularImage reduceModulo(const DenseMatrix<int64_t>& matrix, uint64_t p) {
+    size_t rows = matrix.rows();
+    size_t cols = matrix.cols();
+    int64_t signedPrime = static_cast<int64_t>(p);
+
+    DenseMatrix<uint64_t> reduced(rows, cols);
+    for (size_t i = 0; i < rows * cols; ++i) {
+        int64_t value = matrix.data()[i] % signedPrime;
+        reduced.data()[i] = static_cast<uint64_t>(value < 0 ? value + signedPrime : value);
+    }
+
+    ModularImage image;
+    image.prime = p;
+    size_t col = 0;
+    for (; col < cols && image.pivotColumns.size() < rows; ++col) {
+        size_t pivot = image.pivotColumns.size();
+        size_t pivotRow = pivot;
+        while (pivotRow < rows && reduced(pivotRow, col) == 0) {
+            ++pivotRow;
+        }
+        if (pivotRow == rows) {
+            image.freeColumns.push_back(static_cast<int>(col));
+            continue;
+        }
+        reduced.swapRows(pivot, pivotRow);
+
+        ShoupFactor inverse(inverseMod(reduced(pivot, col), p), p);
+        uint64_t* pivotValues = reduced[pivot].data();
+        for (size_t j = col; j < cols; ++j) {
+            pivotValues[j] = inverse.multiply(pivotValues[j], p);
+        }
+
+        // Entries left of col are zero in the pivot row, so updates start there
+        for (size_t row = 0; row < rows; ++row) {
+            uint64_t value = reduced(row, col);
+            if (row == pivot || value == 0) {
+                continue;
+            }
+            ShoupFactor factor(p - value, p);
+            uint64_t* target = reduced[row].data();
+            for (size_t j = col; j < cols; ++j) {
+                if (pivotValues[j] != 0) {
+                    target[j] = addMod(target[j], factor.multiply(pivotValues[j], p), p);
+                }
+            }
+        }
+        image.pivotColumns.push_back(static_cast<int>(col));
+    }
+    for (; col < cols; ++col) {
+        image.freeColumns.push_back(static_cast<int>(col));
+    }
+
+    size_t freeCount = image.freeColumns.size();
+    image.entries.resize(image.pivotColumns.size() * freeCount);
+    for (size_t k = 0; k < image.pivotColumns.size(); ++k) {
+        for (size_t i = 0; i < freeCount; ++i) {
+            image.entries[k * freeCount + i] = reduced(k, image.freeColumns[i]);
+        }
+    }
+    return image;
+}
+
+// A prime that divides a pivot loses rank or moves a pivot right; over the
+// rationals the pivots are the lexicographically first independent columns
+static bool betterPattern(const std::vector<int>& candidate, const std::vector<int>& current) {
+    if (candidate.size() != current.size()) {
+        return candidate.size() > current.size();
+    }
+    return candidate < current;
+}
+
+// Wang's rational reconstruction, denominator only: the fraction a / b
+// congruent to value with |a| and b within bound, if there is one
+static bool reconstructDenominator(const BigInteger& value, const BigInteger& modulus, const BigInteger& bound,
+                                   BigInteger& denominator) {
+    BigInteger previousRemainder = modulus;
+    BigInteger remainder = value;
+    BigInteger previousCofactor = 0;
+    BigInteger cofactor = 1;
+    while (remainder > bound) {
+        BigInteger quotient;
+        BigInteger nextRemainder;
+        BigInteger::divide(previousRemainder, remainder, quotient, nextRemainder);
+        previousRemainder = std::move(remainder);
+        remainder = std::move(nextRemainder);
+        BigInteger nextCofactor = previousCofactor - quotient * cofactor;
+        previousCofactor = std::move(cofactor);
+        cofactor = std::move(nextCofactor);
+    }
+    if (cofactor.isZero() || cofactor.abs() > bound) {
+        return false;
+    }
+    denominator = cofactor.abs();
+    return true;
+}
+
+// The reduced entries of one free column share most of their denominator,
+// so each entry is first tried with the denominator found so far and only
+// reconstructed when that leaves it out of bounds
+static bool reconstructVector(const ModularImage& pattern, const std::vector<BigInteger>& residues, size_t freeIndex,
+                              const BigInteger& modulus, size_t cols, std::vector<BigInteger>& vector) {
+    size_t freeCount = pattern.freeColumns.size();
+    size_t rank = pattern.pivotColumns.size();
+
+    size_t boundBits = (modulus.bitLength() - 2) / 2;
+    BigInteger bound = 1;
+    for (; boundBits >= 62; boundBits -= 62) {
+        bound *= BigInteger(int64_t(1) << 62);
+    }
+    bound *= BigInteger(int64_t(1) << boundBits);
+    BigInteger half = modulus / BigInteger(2);
+
+    BigInteger denominator = 1;
+    for (size_t k = 0; k < rank; ++k) {
+        BigInteger scaled = residues[k * freeCount + freeIndex] * denominator % modulus;
+        if (scaled <= bound || modulus - scaled <= bound) {
+            continue;
+        }
+        BigInteger extra;
+        if (!reconstructDenominator(scaled, modulus, bound, extra)) {
+            return false;
+        }
+        denominator *= extra;
+        if (denominator > bound) {
+            return false;
+        }
+    }
+
+    vector.assign(cols, BigInteger());
+    vector[pattern.freeColumns[freeIndex]] = denominator;
+    BigInteger divisor = denominator;
+    for (size_t k = 0; k < rank; ++k) {
+        BigInteger scaled = residues[k * freeCount + freeIndex] * denominator % modulus;
+        if (scaled > half) {
+            scaled -= modulus;
+        }
+        vector[pattern.pivotColumns[k]] = -scaled;
+        divisor = BigInteger::gcd(divisor, scaled);
+    }
+    if (divisor > BigInteger(1)) {
+        for (BigInteger& value : vector) {
+            value /= divisor;
+        }
+    }
+    return true;
+}
+
+// A spare prime rejects most wrong candidates before the exact product
+static bool verify(const DenseMatrix<int64_t>& matrix, const std::vector<BigInteger>& vector) {
+    uint64_t check = MultiModularSolver::prime(MultiModularSolver::MAX_PRIMES);
+    int64_t signedCheck = static_cast<int64_t>(check);
+    std::vector<uint64_t> reduced(vector.size());
+    for (size_t col = 0; col < vector.size(); ++col) {
+        reduced[col] = vector[col].mod(check);
+    }
+    for (size_t row = 0; row < matrix.rows(); ++row) {
+        uint64_t sum = 0;
+        for (size_t col = 0; col < matrix.cols(); ++col) {
+            int64_t value = matrix(row, col) % signedCheck;
+            uint64_t entry = static_cast<uint64_t>(value < 0 ? value + signedCheck : value);
+            sum = addMod(sum, mulMod(entry, reduced[col], check), check);
+        }
+        if (sum != 0) {
+            return false;
+        }
+    }
+
+    for (size_t row = 0; row < matrix.rows(); ++row) {
+        BigInteger sum;
+        for (size_t col = 0; col < matrix.cols(); ++col) {
+            if (matrix(row, col) != 0 && !vector[col].isZero()) {
+                sum += vector[col] * BigInteger(matrix(row, col));
+            }
+        }
+        if (!sum.isZero()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+MultiModularSolver::MultiModularSolver() : threadCount_(1), primesUsed_(0), rank_(0) {
+    setThreadCount(0);
+}
+
+void MultiModularSolver::setThreadCount(size_t threads) {
+    threadCount_ = threads != 0 ? threads : std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+ThreadPool& MultiModularSolver::threadPool() {
+    if (!pool_ || pool_->size() != threadCount_) {
+        pool_ = std::make_shared<ThreadPool>(threadCount_);
+    }
+    return *pool_;
+}
+
+size_t MultiModularSolver::getThreadCount() const {
+    return threadCount_;
+}
+
+std::vector<std::vector<BigInteger>> MultiModularSolver::nullspaceBasis(const DenseMatrix<int64_t>& matrix) {
+    primesUsed_ = 0;
+    rank_ = 0;
+    if (matrix.empty()) {
+        return {};
+    }
+
+    // Pattern of the best prime so far, the CRT lift of its entries over
+    // every prime that agrees with it, and the basis vectors accepted since
+    ModularImage pattern;
+    std::vector<BigInteger> residues;
+    BigInteger modulus;
+    std::vector<std::vector<BigInteger>> basis;
+    std::vector<char> accepted;
+
+    while (primesUsed_ < MAX_PRIMES) {
+        size_t batch = std::min(threadCount_, MAX_PRIMES - primesUsed_);
+        size_t first = primesUsed_;
+        std::vector<ModularImage> images(batch);
+        threadPool().parallelFor(batch, [&](size_t i) {
+            images[i] = reduceModulo(matrix, prime(first + i));
+        });
+        primesUsed_ += batch;
+
+        // Merged in prime order whatever the thread count, on this thread:
+        // a merge is cheap next to the reductions
+        for (ModularImage& image : images) {
+            if (modulus.isZero() || betterPattern(image.pivotColumns, pattern.pivotColumns)) {
+                pattern = std::move(image);
+                residues.assign(pattern.entries.begin(), pattern.entries.end());
+                modulus = BigInteger(static_cast<int64_t>(pattern.prime));
+                basis.assign(pattern.freeColumns.size(), {});
+                accepted.assign(pattern.freeColumns.size(), 0);
+            } else if (image.pivotColumns == pattern.pivotColumns) {
+                // x + M * ((r - x) / M mod p) agrees with x modulo M and with r modulo p
+                uint64_t p = image.prime;
+                uint64_t inverse = inverseMod(modulus.mod(p), p);
+                for (size_t i = 0; i < residues.size(); ++i) {
+                    uint64_t current = residues[i].mod(p);
+                    uint64_t target = image.entries[i];
+                    uint64_t step = mulMod(target >= current ? target - current : target + p - current, inverse, p);
+                    if (step != 0) {
+                        residues[i] += modulus * BigInteger(static_cast<int64_t>(step));
+                    }
+                }
+                modulus *= BigInteger(static_cast<int64_t>(p));
+            }
+        }
+        rank_ = pattern.pivotColumns.size();
+
+        for (size_t i = 0; i < basis.size(); ++i) {
+            if (!accepted[i]) {
+                accepted[i] = reconstructVector(pattern, residues, i, modulus, matrix.cols(), basis[i]) &&
+                              verify(matrix, basis[i]);
+            }
+        }
+        if (std::all_of(accepted.begin(), accepted.end(), [](char done) { return done != 0; })) {
+            return basis;
+        }
+    }
+
+    throw std::overflow_error("Coefficients exceed the multi-modular prime budget");
+}
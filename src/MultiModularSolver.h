@@ -0,0 +1,57 @@
+#ifndef MULTI_MODULAR_SOLVER_H
+#define MULTI_MODULAR_SOLVER_H
+
+#include "DenseMatrix.h"
+#include "BigInteger.h"
+#include "ThreadPool.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+// Exact integer nullspace without coefficient blow-up. The matrix is
+// reduced to row echelon form modulo several 62-bit primes, one prime per
+// thread, where every entry stays below 2^62. The reduced entries are
+// combined by the Chinese remainder theorem, recovered as fractions by
+// rational reconstruction, and each basis vector is checked with an exact
+// integer matrix-vector product. More primes are added until every check
+// passes.
+//
+// Primes that divide a pivot produce a different pivot pattern and are
+// discarded, so the result never depends on which primes were used.
+class MultiModularSolver {
+public:
+    // Coefficients beyond roughly 62 * MAX_PRIMES bits are not attempted
+    static constexpr size_t MAX_PRIMES = 256;
+
+private:
+    size_t threadCount_;
+    std::shared_ptr<ThreadPool> pool_; // kept between calls, resized with the thread count
+    size_t primesUsed_;
+    size_t rank_;
+
+    ThreadPool& threadPool();
+
+public:
+    // Uses one thread per hardware thread
+    MultiModularSolver();
+
+    // 0 selects the hardware thread count
+    void setThreadCount(size_t threads);
+    size_t getThreadCount() const;
+
+    // Same basis as MatrixSolver::nullspaceBasis on int64_t, without its
+    // 64-bit limit: one primitive vector per free column, with that column
+    // positive and the other free columns zero. Throws std::overflow_error
+    // if MAX_PRIMES primes are not enough.
+    std::vector<std::vector<BigInteger>> nullspaceBasis(const DenseMatrix<int64_t>& matrix);
+
+    // Primes reduced by the last call, including discarded ones, and the
+    // rank it found
+    size_t primesUsed() const { return primesUsed_; }
+    size_t rank() const { return rank_; }
+
+    // The index-th prime below 2^62, counting down
+    static uint64_t prime(size_t index);
+};
+
+#endif // MULTI_MODULAR_SOLVER_H
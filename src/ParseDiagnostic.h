@@ -0,0 +1,40 @@
+#ifndef PARSE_DIAGNOSTIC_H
+#define PARSE_DIAGNOSTIC_H
+
+#include <string>
+#include <cstddef>
+
+enum class ParseStatus {
+    OK,
+    EMPTY_FORMULA,
+    INVALID_CHARACTER,
+    UNMATCHED_PARENTHESIS,
+    UNKNOWN_ELEMENT,
+    COUNT_OVERFLOW,
+    INVALID_TERM,
+    COEFFICIENT_OVERFLOW,
+    MISSING_ARROW,
+    EXTRA_ARROW,
+    EMPTY_SIDE,
+    NESTING_TOO_DEEP,
+    TOO_MANY_TERMS,
+    TOO_MANY_ELEMENTS
+};
+
+// Result of the exception-free parse path. The reason always points to a
+// string literal, so producing a diagnostic never allocates.
+struct ParseDiagnostic {
+    ParseStatus status;
+    size_t position; // byte offset into the parsed text
+    const char* reason;
+
+    constexpr bool ok() const { return status == ParseStatus::OK; }
+
+    static constexpr ParseDiagnostic success() { return {ParseStatus::OK, 0, ""}; }
+
+    std::string toString() const {
+        return std::string(reason) + " at position " + std::to_string(position);
+    }
+};
+
+#endif // PARSE_DIAGNOSTIC_H
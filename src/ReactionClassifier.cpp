@@ -1,10 +1,11 @@
 #include "ReactionClassifier.h"
+#include "CompoundDatabase.h"
 #include <algorithm>
 #include <sstream>
 
 bool ReactionClassifier::containsElement(const ChemicalCompound& compound, const std::string& element) {
-    auto elements = compound.getElementCount();
-    return elements.find(element) != elements.end();
+    int atomicNumber = CompoundDatabase::getInstance().getAtomicNumber(element);
+    return atomicNumber != 0 && compound.getElementCount(atomicNumber) > 0;
 }
 
 bool ReactionClassifier::isOxygen(const ChemicalCompound& compound) {
@@ -57,8 +58,7 @@ bool ReactionClassifier::isSalt(const ChemicalCompound& compound) {
 }
 
 bool ReactionClassifier::isHydrocarbon(const ChemicalCompound& compound) {
-    auto elements = compound.getElementCount();
-    return elements.size() <= 2 && 
+    return compound.getElements().size() <= 2 && 
            containsElement(compound, "C") && 
            containsElement(compound, "H");
 }
@@ -0,0 +1,290 @@
+#include "RowKernels.h"
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define ROW_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+static void scalePortable(double* row, size_t count, double factor) {
+    for (size_t i = 0; i < count; ++i) {
+        row[i] *= factor;
+    }
+}
+
+static void axpyPortable(double* target, const double* source, size_t count, double factor) {
+    for (size_t i = 0; i < count; ++i) {
+        target[i] += factor * source[i];
+    }
+}
+
+static size_t maxAbsIndexPortable(const double* values, size_t count, size_t stride, size_t start, size_t best, double bestValue) {
+    for (size_t i = start; i < count; ++i) {
+        double value = std::abs(values[i * stride]);
+        if (value > bestValue) {
+            best = i;
+            bestValue = value;
+        }
+    }
+    return best;
+}
+
+static void fractionFreeLanesPortable(double* target, const double* source, const double* pivot,
+                                      const double* factor, const double* previous, double* magnitude, size_t count) {
+    const size_t lanes = RowKernels::LANES;
+    for (size_t j = 0; j < count; ++j) {
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            double kept = pivot[lane] * target[j * lanes + lane];
+            double removed = factor[lane] * source[j * lanes + lane];
+            magnitude[lane] = std::max(magnitude[lane], std::max(std::abs(kept), std::abs(removed)));
+            target[j * lanes + lane] = (kept - removed) / previous[lane];
+        }
+    }
+}
+
+#ifdef ROW_KERNELS_X86
+
+__attribute__((target("avx2")))
+static void scaleAvx2(double* row, size_t count, double factor) {
+    __m256d scale = _mm256_set1_pd(factor);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm256_storeu_pd(row + i, _mm256_mul_pd(_mm256_loadu_pd(row + i), scale));
+    }
+    scalePortable(row + i, count - i, factor);
+}
+
+__attribute__((target("avx2")))
+static void axpyAvx2(double* target, const double* source, size_t count, double factor) {
+    __m256d scale = _mm256_set1_pd(factor);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d product = _mm256_mul_pd(_mm256_loadu_pd(source + i), scale);
+        _mm256_storeu_pd(target + i, _mm256_add_pd(_mm256_loadu_pd(target + i), product));
+    }
+    axpyPortable(target + i, source + i, count - i, factor);
+}
+
+// Each lane keeps the first maximum of its own entries; the lane reduction
+// then breaks ties on the lowest index, which is the scalar loop's answer
+__attribute__((target("avx2")))
+static size_t maxAbsIndexAvx2(const double* values, size_t count, size_t stride) {
+    const __m256d signBit = _mm256_set1_pd(-0.0);
+    const __m256i offsets = _mm256_set_epi64x(3 * stride, 2 * stride, stride, 0);
+    __m256d bestValues = _mm256_set1_pd(-1.0);
+    __m256i bestIndices = _mm256_setzero_si256();
+    __m256i indices = _mm256_set_epi64x(3, 2, 1, 0);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d loaded = stride == 1 ? _mm256_loadu_pd(values + i)
+                                     : _mm256_i64gather_pd(values + i * stride, offsets, 8);
+        __m256d magnitudes = _mm256_andnot_pd(signBit, loaded);
+        __m256d greater = _mm256_cmp_pd(magnitudes, bestValues, _CMP_GT_OQ);
+        bestValues = _mm256_blendv_pd(bestValues, magnitudes, greater);
+        bestIndices = _mm256_blendv_epi8(bestIndices, indices, _mm256_castpd_si256(greater));
+        indices = _mm256_add_epi64(indices, _mm256_set1_epi64x(4));
+    }
+
+    alignas(32) double laneValues[4];
+    alignas(32) int64_t laneIndices[4];
+    _mm256_store_pd(laneValues, bestValues);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(laneIndices), bestIndices);
+    size_t best = 0;
+    double bestValue = -1.0;
+    for (int lane = 0; lane < 4; ++lane) {
+        size_t index = static_cast<size_t>(laneIndices[lane]);
+        if (laneValues[lane] > bestValue || (laneValues[lane] == bestValue && index < best)) {
+            best = index;
+            bestValue = laneValues[lane];
+        }
+    }
+    return maxAbsIndexPortable(values, count, stride, i, best, bestValue);
+}
+
+// Two 4-wide halves per entry
+__attribute__((target("avx2")))
+static void fractionFreeLanesAvx2(double* target, const double* source, const double* pivot,
+                                  const double* factor, const double* previous, double* magnitude, size_t count) {
+    const __m256d signBit = _mm256_set1_pd(-0.0);
+    for (size_t half = 0; half < RowKernels::LANES; half += 4) {
+        __m256d pivots = _mm256_loadu_pd(pivot + half);
+        __m256d factors = _mm256_loadu_pd(factor + half);
+        __m256d divisors = _mm256_loadu_pd(previous + half);
+        __m256d largest = _mm256_loadu_pd(magnitude + half);
+        for (size_t j = 0; j < count; ++j) {
+            double* entry = target + j * RowKernels::LANES + half;
+            __m256d kept = _mm256_mul_pd(pivots, _mm256_loadu_pd(entry));
+            __m256d removed = _mm256_mul_pd(factors, _mm256_loadu_pd(source + j * RowKernels::LANES + half));
+            largest = _mm256_max_pd(largest, _mm256_max_pd(_mm256_andnot_pd(signBit, kept), _mm256_andnot_pd(signBit, removed)));
+            _mm256_storeu_pd(entry, _mm256_div_pd(_mm256_sub_pd(kept, removed), divisors));
+        }
+        _mm256_storeu_pd(magnitude + half, largest);
+    }
+}
+
+__attribute__((target("avx512f")))
+static void scaleAvx512(double* row, size_t count, double factor) {
+    __m512d scale = _mm512_set1_pd(factor);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm512_storeu_pd(row + i, _mm512_mul_pd(_mm512_loadu_pd(row + i), scale));
+    }
+    if (i < count) {
+        __mmask8 tail = static_cast<__mmask8>((1u << (count - i)) - 1);
+        _mm512_mask_storeu_pd(row + i, tail, _mm512_mul_pd(_mm512_maskz_loadu_pd(tail, row + i), scale));
+    }
+}
+
+// GCC treats AVX-512F as implying FMA and would fuse the multiply and add,
+// which rounds once and differs from the portable loop in the last bit
+__attribute__((target("avx512f"), optimize("fp-contract=off")))
+static void axpyAvx512(double* target, const double* source, size_t count, double factor) {
+    __m512d scale = _mm512_set1_pd(factor);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m512d product = _mm512_mul_pd(_mm512_loadu_pd(source + i), scale);
+        _mm512_storeu_pd(target + i, _mm512_add_pd(_mm512_loadu_pd(target + i), product));
+    }
+    if (i < count) {
+        __mmask8 tail = static_cast<__mmask8>((1u << (count - i)) - 1);
+        __m512d product = _mm512_mul_pd(_mm512_maskz_loadu_pd(tail, source + i), scale);
+        _mm512_mask_storeu_pd(target + i, tail, _mm512_add_pd(_mm512_maskz_loadu_pd(tail, target + i), product));
+    }
+}
+
+__attribute__((target("avx512f")))
+static size_t maxAbsIndexAvx512(const double* values, size_t count, size_t stride) {
+    const int64_t step = static_cast<int64_t>(stride);
+    const __m512i offsets = _mm512_set_epi64(7 * step, 6 * step, 5 * step, 4 * step, 3 * step, 2 * step, step, 0);
+    __m512d bestValues = _mm512_set1_pd(-1.0);
+    __m512i bestIndices = _mm512_setzero_si512();
+    __m512i indices = _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m512d loaded = stride == 1 ? _mm512_loadu_pd(values + i)
+                                     : _mm512_mask_i64gather_pd(_mm512_setzero_pd(), 0xFF, offsets, values + i * stride, 8);
+        __m512d magnitudes = _mm512_abs_pd(loaded);
+        __mmask8 greater = _mm512_cmp_pd_mask(magnitudes, bestValues, _CMP_GT_OQ);
+        bestValues = _mm512_mask_blend_pd(greater, bestValues, magnitudes);
+        bestIndices = _mm512_mask_blend_epi64(greater, bestIndices, indices);
+        indices = _mm512_add_epi64(indices, _mm512_set1_epi64(8));
+    }
+
+    alignas(64) double laneValues[8];
+    alignas(64) int64_t laneIndices[8];
+    _mm512_store_pd(laneValues, bestValues);
+    _mm512_store_si512(laneIndices, bestIndices);
+    size_t best = 0;
+    double bestValue = -1.0;
+    for (int lane = 0; lane < 8; ++lane) {
+        size_t index = static_cast<size_t>(laneIndices[lane]);
+        if (laneValues[lane] > bestValue || (laneValues[lane] == bestValue && index < best)) {
+            best = index;
+            bestValue = laneValues[lane];
+        }
+    }
+    return maxAbsIndexPortable(values, count, stride, i, best, bestValue);
+}
+
+__attribute__((target("avx512f")))
+static void fractionFreeLanesAvx512(double* target, const double* source, const double* pivot,
+                                    const double* factor, const double* previous, double* magnitude, size_t count) {
+    __m512d pivots = _mm512_loadu_pd(pivot);
+    __m512d factors = _mm512_loadu_pd(factor);
+    __m512d divisors = _mm512_loadu_pd(previous);
+    __m512d largest = _mm512_loadu_pd(magnitude);
+    for (size_t j = 0; j < count; ++j) {
+        double* entry = target + j * RowKernels::LANES;
+        __m512d kept = _mm512_mul_pd(pivots, _mm512_loadu_pd(entry));
+        __m512d removed = _mm512_mul_pd(factors, _mm512_loadu_pd(source + j * RowKernels::LANES));
+        largest = _mm512_maskz_max_pd(0xFF, largest, _mm512_maskz_max_pd(0xFF, _mm512_abs_pd(kept), _mm512_abs_pd(removed)));
+        _mm512_storeu_pd(entry, _mm512_div_pd(_mm512_sub_pd(kept, removed), divisors));
+    }
+    _mm512_storeu_pd(magnitude, largest);
+}
+
+#endif // ROW_KERNELS_X86
+
+KernelLevel RowKernels::supportedLevel() {
+#ifdef ROW_KERNELS_X86
+    static const KernelLevel supported = __builtin_cpu_supports("avx512f") ? KernelLevel::AVX512
+                                       : __builtin_cpu_supports("avx2") ? KernelLevel::AVX2
+                                       : KernelLevel::PORTABLE;
+    return supported;
+#else
+    return KernelLevel::PORTABLE;
+#endif
+}
+
+static std::atomic<KernelLevel>& activeLevel() {
+    static std::atomic<KernelLevel> level{RowKernels::supportedLevel()};
+    return level;
+}
+
+KernelLevel RowKernels::getLevel() {
+    return activeLevel().load(std::memory_order_relaxed);
+}
+
+void RowKernels::setLevel(KernelLevel level) {
+    if (static_cast<int>(level) > static_cast<int>(supportedLevel())) {
+        level = supportedLevel();
+    }
+    activeLevel().store(level, std::memory_order_relaxed);
+}
+
+const char* RowKernels::levelName(KernelLevel level) {
+    switch (level) {
+        case KernelLevel::AVX2: return "avx2";
+        case KernelLevel::AVX512: return "avx512";
+        default: return "portable";
+    }
+}
+
+void RowKernels::scale(double* row, size_t count, double factor) {
+    switch (getLevel()) {
+#ifdef ROW_KERNELS_X86
+        case KernelLevel::AVX512: scaleAvx512(row, count, factor); return;
+        case KernelLevel::AVX2: scaleAvx2(row, count, factor); return;
+#endif
+        default: scalePortable(row, count, factor); return;
+    }
+}
+
+void RowKernels::axpy(double* target, const double* source, size_t count, double factor) {
+    switch (getLevel()) {
+#ifdef ROW_KERNELS_X86
+        case KernelLevel::AVX512: axpyAvx512(target, source, count, factor); return;
+        case KernelLevel::AVX2: axpyAvx2(target, source, count, factor); return;
+#endif
+        default: axpyPortable(target, source, count, factor); return;
+    }
+}
+
+size_t RowKernels::maxAbsIndex(const double* values, size_t count, size_t stride) {
+    // Short columns, the usual case with a handful of elements, finish
+    // before the lane reduction of the vector search would pay off
+    KernelLevel level = count < MIN_VECTOR_SEARCH ? KernelLevel::PORTABLE : getLevel();
+    switch (level) {
+#ifdef ROW_KERNELS_X86
+        case KernelLevel::AVX512: return maxAbsIndexAvx512(values, count, stride);
+        case KernelLevel::AVX2: return maxAbsIndexAvx2(values, count, stride);
+#endif
+        default: return count == 0 ? 0 : maxAbsIndexPortable(values, count, stride, 1, 0, std::abs(values[0]));
+    }
+}
+
+void RowKernels::fractionFreeLanes(double* target, const double* source, const double* pivot, const double* factor,
+                                   const double* previous, double* magnitude, size_t count) {
+    switch (getLevel()) {
+#ifdef ROW_KERNELS_X86
+        case KernelLevel::AVX512: fractionFreeLanesAvx512(target, source, pivot, factor, previous, magnitude, count); return;
+        case KernelLevel::AVX2: fractionFreeLanesAvx2(target, source, pivot, factor, previous, magnitude, count); return;
+#endif
+        default: fractionFreeLanesPortable(target, source, pivot, factor, previous, magnitude, count); return;
+    }
+}
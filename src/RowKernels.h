@@ -0,0 +1,48 @@
+#ifndef ROW_KERNELS_H
+#define ROW_KERNELS_H
+
+#include <cstddef>
+
+enum class KernelLevel {
+    PORTABLE,
+    AVX2,
+    AVX512
+};
+
+// Vectorized inner loops of dense floating-point elimination. The widest
+// instruction set the build and the running CPU both support is picked on
+// first use; the portable loops cover every other target.
+//
+// Products and sums are rounded separately (no fused multiply-add), so every
+// level produces the same bits as the portable loop and solver output does
+// not depend on the machine it runs on.
+class RowKernels {
+public:
+    // Pivot searches over fewer entries stay scalar
+    static constexpr size_t MIN_VECTOR_SEARCH = 32;
+    // Independent systems interleaved per entry by fractionFreeLanes
+    static constexpr size_t LANES = 8;
+
+    // Best level available here, and the level currently in use
+    static KernelLevel supportedLevel();
+    static KernelLevel getLevel();
+    // Selects a level, clamped to supportedLevel(); used to compare levels
+    static void setLevel(KernelLevel level);
+    static const char* levelName(KernelLevel level);
+
+    // row[i] *= factor
+    static void scale(double* row, size_t count, double factor);
+    // target[i] += factor * source[i]
+    static void axpy(double* target, const double* source, size_t count, double factor);
+    // Index of the first entry of largest magnitude among values[i * stride],
+    // i < count, which is the partial pivoting rule; 0 when count is 0
+    static size_t maxAbsIndex(const double* values, size_t count, size_t stride);
+    // One fraction-free row update on count entries of LANES interleaved
+    // systems, entry j of lane l at [j * LANES + l]:
+    // target = (pivot * target - factor * source) / previous, lane by lane.
+    // magnitude keeps the largest product magnitude seen in each lane.
+    static void fractionFreeLanes(double* target, const double* source, const double* pivot, const double* factor,
+                                  const double* previous, double* magnitude, size_t count);
+};
+
+#endif // ROW_KERNELS_H
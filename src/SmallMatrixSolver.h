@@ -0,0 +1,192 @@
+#ifndef SMALL_MATRIX_SOLVER_H
+#define SMALL_MATRIX_SOLVER_H
+
+#include "CheckedArithmetic.h"
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+
+// Exact nullspace of a small integer system held entirely on the stack.
+// Computes the same basis as MatrixSolver::nullspaceBasis on int64_t, by
+// the same fraction-free elimination, without heap allocation or step
+// recording.
+//
+// Storage is always MaxRows x MaxCols with the unused rows and columns
+// zero. Zeros stay zero under every row operation, so the inner loops run
+// over the full compile-time width and unroll completely; only the pivot
+// search and the free-column scan look at the real size.
+template <size_t MaxRows, size_t MaxCols>
+class SmallMatrixSolver {
+public:
+    static constexpr size_t MAX_ROWS = MaxRows;
+    static constexpr size_t MAX_COLS = MaxCols;
+
+    using Row = std::array<int64_t, MaxCols>;
+
+private:
+    std::array<Row, MaxRows> matrix_;
+    std::array<Row, MaxCols> basis_;
+    std::array<size_t, MaxRows> pivotColumns_;
+    size_t rows_;
+    size_t cols_;
+    size_t rank_;
+    size_t nullity_;
+
+    static void makePrimitive(Row& row, size_t pivotCol) {
+        int64_t divisor = 0;
+#pragma GCC unroll 16
+        for (size_t j = 0; j < MaxCols; ++j) {
+            divisor = gcd64(divisor, row[j]);
+        }
+        if (row[pivotCol] < 0) {
+            divisor = -divisor;
+        }
+        if (divisor != 0 && divisor != 1) {
+#pragma GCC unroll 16
+            for (size_t j = 0; j < MaxCols; ++j) {
+                row[j] /= divisor;
+            }
+        }
+    }
+
+    void reduce() {
+        rank_ = 0;
+        int64_t previousPivot = 1;
+        for (size_t col = 0; col < cols_ && rank_ < rows_; ++col) {
+            size_t pivotRow = rows_;
+            for (size_t row = rank_; row < rows_; ++row) {
+                if (matrix_[row][col] != 0 &&
+                    (pivotRow == rows_ || std::abs(matrix_[row][col]) < std::abs(matrix_[pivotRow][col]))) {
+                    pivotRow = row;
+                }
+            }
+            if (pivotRow == rows_) {
+                continue;
+            }
+            if (pivotRow != rank_) {
+                std::swap(matrix_[rank_], matrix_[pivotRow]);
+            }
+
+            const Row& pivot = matrix_[rank_];
+            int64_t pivotValue = pivot[col];
+            for (size_t row = rank_ + 1; row < rows_; ++row) {
+                Row& target = matrix_[row];
+                int64_t factor = target[col];
+#pragma GCC unroll 16
+                for (size_t j = 0; j < MaxCols; ++j) {
+                    target[j] = checkedSubtract(checkedMultiply(pivotValue, target[j]),
+                                                checkedMultiply(factor, pivot[j])) / previousPivot;
+                }
+            }
+
+            previousPivot = pivotValue;
+            pivotColumns_[rank_++] = col;
+        }
+
+        for (size_t k = 0; k < rank_; ++k) {
+            makePrimitive(matrix_[k], pivotColumns_[k]);
+        }
+
+        for (size_t k = rank_; k-- > 1;) {
+            const Row& pivot = matrix_[k];
+            int64_t pivotValue = pivot[pivotColumns_[k]];
+            for (size_t row = 0; row < k; ++row) {
+                Row& target = matrix_[row];
+                int64_t factor = target[pivotColumns_[k]];
+                if (factor == 0) {
+                    continue;
+                }
+#pragma GCC unroll 16
+                for (size_t j = 0; j < MaxCols; ++j) {
+                    target[j] = checkedSubtract(checkedMultiply(pivotValue, target[j]),
+                                                checkedMultiply(factor, pivot[j]));
+                }
+                makePrimitive(target, pivotColumns_[row]);
+            }
+        }
+    }
+
+public:
+    static constexpr bool fits(size_t rows, size_t cols) {
+        return rows <= MaxRows && cols <= MaxCols;
+    }
+
+    SmallMatrixSolver() : rows_(0), cols_(0), rank_(0), nullity_(0) {}
+
+    // Zeroes the storage; requires fits(rows, cols)
+    void reset(size_t rows, size_t cols) {
+        for (Row& row : matrix_) {
+            row.fill(0);
+        }
+        rows_ = rows;
+        cols_ = cols;
+        rank_ = 0;
+        nullity_ = 0;
+    }
+
+    int64_t& at(size_t row, size_t col) { return matrix_[row][col]; }
+
+    // Reduces the matrix and returns the nullspace dimension. Throws
+    // std::overflow_error when an intermediate value does not fit in 64
+    // bits, leaving the matrix partly reduced.
+    size_t solve() {
+        reduce();
+
+        // As in MatrixSolver: each free variable set to the lcm of the
+        // reduced pivots it meets, then the vector made primitive
+        nullity_ = 0;
+        size_t nextPivot = 0;
+        for (size_t col = 0; col < cols_; ++col) {
+            if (nextPivot < rank_ && pivotColumns_[nextPivot] == col) {
+                ++nextPivot;
+                continue;
+            }
+
+            int64_t scale = 1;
+            for (size_t k = 0; k < rank_; ++k) {
+                int64_t entry = matrix_[k][col];
+                if (entry != 0) {
+                    int64_t pivotValue = matrix_[k][pivotColumns_[k]];
+                    int64_t denominator = pivotValue / gcd64(entry, pivotValue);
+                    scale = checkedMultiply(scale / gcd64(scale, denominator), denominator);
+                }
+            }
+
+            Row& vector = basis_[nullity_++];
+            vector.fill(0);
+            vector[col] = scale;
+            for (size_t k = 0; k < rank_; ++k) {
+                int64_t entry = matrix_[k][col];
+                if (entry != 0) {
+                    int64_t pivotValue = matrix_[k][pivotColumns_[k]];
+                    int64_t divisor = gcd64(entry, pivotValue);
+                    vector[pivotColumns_[k]] = -checkedMultiply(entry / divisor, scale / (pivotValue / divisor));
+                }
+            }
+
+            int64_t divisor = 0;
+#pragma GCC unroll 16
+            for (size_t j = 0; j < MaxCols; ++j) {
+                divisor = gcd64(divisor, vector[j]);
+            }
+            if (divisor > 1) {
+#pragma GCC unroll 16
+                for (size_t j = 0; j < MaxCols; ++j) {
+                    vector[j] /= divisor;
+                }
+            }
+        }
+
+        return nullity_;
+    }
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    size_t rank() const { return rank_; }
+    size_t nullity() const { return nullity_; }
+
+    // Basis vector k of the last solve, valid in its first cols() entries
+    const Row& basisVector(size_t k) const { return basis_[k]; }
+};
+
+#endif // SMALL_MATRIX_SOLVER_H
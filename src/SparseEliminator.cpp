@@ -0,0 +1,354 @@
+#include "SparseEliminator.h"
+#include "CheckedArithmetic.h"
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <utility>
+
+// Entries below this are treated as cancelled, as MatrixSolver::isZero does
+static const double SPARSE_EPSILON = 1e-10;
+
+static int64_t magnitude(int64_t value) { return value < 0 ? -value : value; }
+
+template <>
+bool SparseEliminator<double>::acceptable(const double& value, const double& rowMax) {
+    return std::abs(value) >= PIVOT_THRESHOLD * rowMax;
+}
+
+template <>
+bool SparseEliminator<int64_t>::acceptable(const int64_t&, const int64_t&) {
+    return true;
+}
+
+// Ties on Markowitz cost go to the larger double pivot (stability) and to
+// the smaller integer pivot (slower coefficient growth)
+template <>
+bool SparseEliminator<double>::preferable(const double& value, const double& current) {
+    return std::abs(value) > std::abs(current);
+}
+
+template <>
+bool SparseEliminator<int64_t>::preferable(const int64_t& value, const int64_t& current) {
+    return magnitude(value) < magnitude(current);
+}
+
+template <>
+void SparseEliminator<double>::combine(const SparseRow<double>& target, const SparseRow<double>& pivot, int col,
+                                       const double& targetValue, const double& pivotValue, SparseRow<double>& result) {
+    double factor = -targetValue / pivotValue;
+    result.clear();
+
+    size_t i = 0;
+    size_t j = 0;
+    while (i < target.size() || j < pivot.size()) {
+        int column;
+        double value;
+        if (j == pivot.size() || (i < target.size() && target[i].col < pivot[j].col)) {
+            column = target[i].col;
+            value = target[i++].value;
+        } else if (i == target.size() || pivot[j].col < target[i].col) {
+            column = pivot[j].col;
+            value = factor * pivot[j++].value;
+        } else {
+            column = target[i].col;
+            value = target[i++].value + factor * pivot[j++].value;
+        }
+        if (column != col && std::abs(value) >= SPARSE_EPSILON) {
+            result.push_back({column, value});
+        }
+    }
+}
+
+template <>
+void SparseEliminator<int64_t>::combine(const SparseRow<int64_t>& target, const SparseRow<int64_t>& pivot, int col,
+                                        const int64_t& targetValue, const int64_t& pivotValue, SparseRow<int64_t>& result) {
+    // (p / g) * target - (a / g) * pivot clears the column with the smallest multipliers
+    int64_t divisor = gcd64(targetValue, pivotValue);
+    int64_t targetScale = pivotValue / divisor;
+    int64_t pivotScale = targetValue / divisor;
+    result.clear();
+
+    size_t i = 0;
+    size_t j = 0;
+    int64_t content = 0;
+    while (i < target.size() || j < pivot.size()) {
+        int column;
+        int64_t value;
+        if (j == pivot.size() || (i < target.size() && target[i].col < pivot[j].col)) {
+            column = target[i].col;
+            value = checkedMultiply(targetScale, target[i++].value);
+        } else if (i == target.size() || pivot[j].col < target[i].col) {
+            column = pivot[j].col;
+            value = -checkedMultiply(pivotScale, pivot[j++].value);
+        } else {
+            column = target[i].col;
+            value = checkedSubtract(checkedMultiply(targetScale, target[i++].value),
+                                    checkedMultiply(pivotScale, pivot[j++].value));
+        }
+        if (column != col && value != 0) {
+            result.push_back({column, value});
+            content = gcd64(content, value);
+        }
+    }
+
+    // Primitive rows keep the entries as small as exact arithmetic allows
+    if (content > 1) {
+        for (SparseEntry<int64_t>& entry : result) {
+            entry.value /= content;
+        }
+    }
+}
+
+template <typename T>
+void SparseEliminator<T>::factorize(SparseMatrix<T> matrix) {
+    size_t rows = matrix.rows();
+    cols_ = matrix.cols();
+    pivotRows_.clear();
+    pivotColumns_.clear();
+    freeColumns_.clear();
+
+    // Active rows are kept ordered by length for the pivot search; column
+    // counts are exact, column row lists may hold stale rows that are
+    // skipped when read
+    std::vector<size_t> colCount(cols_, 0);
+    std::vector<std::vector<int>> colRows(cols_);
+    std::vector<bool> active(rows, false);
+    std::set<std::pair<size_t, int>> byLength;
+
+    size_t nonZeros = 0;
+    for (size_t row = 0; row < rows; ++row) {
+        SparseRow<T>& entries = matrix.row(row);
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                     [](const SparseEntry<T>& entry) { return entry.value == T(); }),
+                      entries.end());
+        for (const SparseEntry<T>& entry : entries) {
+            ++colCount[entry.col];
+            colRows[entry.col].push_back(static_cast<int>(row));
+        }
+        if (!entries.empty()) {
+            active[row] = true;
+            byLength.insert({entries.size(), static_cast<int>(row)});
+        }
+        nonZeros += entries.size();
+    }
+    initialNonZeros_ = nonZeros;
+    peakNonZeros_ = nonZeros;
+
+    // Columns down to a single active row cost nothing to pivot on: no other
+    // row holds them, so there is nothing to eliminate and no fill-in
+    std::vector<int> singletons;
+    for (size_t col = 0; col < cols_; ++col) {
+        if (colCount[col] == 1) {
+            singletons.push_back(static_cast<int>(col));
+        }
+    }
+    auto release = [&](const SparseRow<T>& entries) {
+        for (const SparseEntry<T>& entry : entries) {
+            if (--colCount[entry.col] == 1) {
+                singletons.push_back(entry.col);
+            }
+        }
+    };
+
+    std::vector<size_t> visited(rows, 0);
+    size_t stamp = 0;
+    SparseRow<T> combined;
+
+    while (!byLength.empty()) {
+        int pivotRow = -1;
+        int pivotCol = -1;
+        T pivotValue = T();
+        size_t bestCost = static_cast<size_t>(-1);
+
+        // No elimination follows a singleton pivot, so it needs no threshold
+        while (!singletons.empty() && pivotRow == -1) {
+            int col = singletons.back();
+            singletons.pop_back();
+            if (colCount[col] != 1) {
+                continue;
+            }
+            for (int row : colRows[col]) {
+                if (!active[row]) {
+                    continue;
+                }
+                const SparseRow<T>& entries = matrix.row(row);
+                auto it = std::lower_bound(entries.begin(), entries.end(), col,
+                                           [](const SparseEntry<T>& entry, int column) { return entry.col < column; });
+                if (it != entries.end() && it->col == col) {
+                    pivotRow = row;
+                    pivotCol = col;
+                    pivotValue = it->value;
+                    bestCost = 0;
+                    break;
+                }
+            }
+        }
+
+        // Otherwise a Markowitz search over the shortest rows
+        size_t examined = 0;
+        for (auto it = byLength.begin(); it != byLength.end() && examined < SEARCH_ROWS && bestCost > 0; ++it, ++examined) {
+            const SparseRow<T>& entries = matrix.row(it->second);
+            T rowMax = T();
+            for (const SparseEntry<T>& entry : entries) {
+                T value = entry.value < T() ? -entry.value : entry.value;
+                rowMax = std::max(rowMax, value);
+            }
+
+            for (const SparseEntry<T>& entry : entries) {
+                if (!acceptable(entry.value, rowMax)) {
+                    continue;
+                }
+                size_t cost = (entries.size() - 1) * (colCount[entry.col] - 1);
+                if (cost < bestCost || (cost == bestCost && preferable(entry.value, pivotValue))) {
+                    bestCost = cost;
+                    pivotRow = it->second;
+                    pivotCol = entry.col;
+                    pivotValue = entry.value;
+                }
+            }
+        }
+
+        SparseRow<T>& pivot = matrix.row(pivotRow);
+        byLength.erase({pivot.size(), pivotRow});
+        active[pivotRow] = false;
+        release(pivot);
+
+        ++stamp;
+        for (int row : colRows[pivotCol]) {
+            if (!active[row] || visited[row] == stamp) {
+                continue;
+            }
+            visited[row] = stamp;
+
+            SparseRow<T>& target = matrix.row(row);
+            auto it = std::lower_bound(target.begin(), target.end(), pivotCol,
+                                       [](const SparseEntry<T>& entry, int column) { return entry.col < column; });
+            if (it == target.end() || it->col != pivotCol) {
+                continue;
+            }
+
+            combine(target, pivot, pivotCol, it->value, pivotValue, combined);
+
+            // Fill-in: the row joins the lists of columns it did not have
+            size_t k = 0;
+            for (const SparseEntry<T>& entry : combined) {
+                while (k < target.size() && target[k].col < entry.col) {
+                    ++k;
+                }
+                if (k == target.size() || target[k].col != entry.col) {
+                    colRows[entry.col].push_back(row);
+                }
+            }
+
+            byLength.erase({target.size(), row});
+            for (const SparseEntry<T>& entry : combined) {
+                ++colCount[entry.col];
+            }
+            release(target);
+            nonZeros = nonZeros - target.size() + combined.size();
+            target.swap(combined);
+
+            if (target.empty()) {
+                active[row] = false;
+            } else {
+                byLength.insert({target.size(), row});
+            }
+        }
+        colRows[pivotCol].clear();
+        colRows[pivotCol].shrink_to_fit();
+        peakNonZeros_ = std::max(peakNonZeros_, nonZeros);
+
+        pivotRows_.push_back(std::move(pivot));
+        pivotColumns_.push_back(pivotCol);
+    }
+
+    std::vector<bool> isPivot(cols_, false);
+    for (int col : pivotColumns_) {
+        isPivot[col] = true;
+    }
+    for (size_t col = 0; col < cols_; ++col) {
+        if (!isPivot[col]) {
+            freeColumns_.push_back(static_cast<int>(col));
+        }
+    }
+}
+
+// Each pivot row holds its pivot, later pivots and free columns only, so
+// walking the pivots backwards solves one variable per row
+template <>
+std::vector<double> SparseEliminator<double>::nullVector(int freeColumn) const {
+    std::vector<double> solution(cols_, 0.0);
+    solution[freeColumn] = 1.0;
+
+    for (size_t k = pivotRows_.size(); k-- > 0;) {
+        double sum = 0.0;
+        double pivotValue = 0.0;
+        for (const SparseEntry<double>& entry : pivotRows_[k]) {
+            if (entry.col == pivotColumns_[k]) {
+                pivotValue = entry.value;
+            } else {
+                sum += entry.value * solution[entry.col];
+            }
+        }
+        solution[pivotColumns_[k]] = -sum / pivotValue;
+    }
+    return solution;
+}
+
+template <>
+std::vector<int64_t> SparseEliminator<int64_t>::nullVector(int freeColumn) const {
+    std::vector<int64_t> solution(cols_, 0);
+    std::vector<int> nonZero = {freeColumn};
+    solution[freeColumn] = 1;
+
+    // A pivot that does not divide its right-hand side scales the whole
+    // vector up, as MatrixSolver's dense integer back substitution does
+    for (size_t k = pivotRows_.size(); k-- > 0;) {
+        int64_t sum = 0;
+        int64_t pivotValue = 0;
+        for (const SparseEntry<int64_t>& entry : pivotRows_[k]) {
+            if (entry.col == pivotColumns_[k]) {
+                pivotValue = entry.value;
+            } else if (solution[entry.col] != 0) {
+                sum = checkedAdd(sum, checkedMultiply(entry.value, solution[entry.col]));
+            }
+        }
+        if (sum == 0) {
+            continue;
+        }
+
+        int64_t scale = magnitude(pivotValue / gcd64(sum, pivotValue));
+        if (scale != 1) {
+            for (int col : nonZero) {
+                solution[col] = checkedMultiply(solution[col], scale);
+            }
+            sum = checkedMultiply(sum, scale);
+        }
+        solution[pivotColumns_[k]] = -sum / pivotValue;
+        nonZero.push_back(pivotColumns_[k]);
+    }
+
+    int64_t content = 0;
+    for (int col : nonZero) {
+        content = gcd64(content, solution[col]);
+    }
+    if (content > 1) {
+        for (int col : nonZero) {
+            solution[col] /= content;
+        }
+    }
+    return solution;
+}
+
+template <typename T>
+std::vector<std::vector<T>> SparseEliminator<T>::nullspaceBasis() const {
+    std::vector<std::vector<T>> basis;
+    basis.reserve(freeColumns_.size());
+    for (int col : freeColumns_) {
+        basis.push_back(nullVector(col));
+    }
+    return basis;
+}
+
+template class SparseEliminator<double>;
+template class SparseEliminator<int64_t>;
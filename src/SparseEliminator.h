@@ -0,0 +1,66 @@
+#ifndef SPARSE_ELIMINATOR_H
+#define SPARSE_ELIMINATOR_H
+
+#include "SparseMatrix.h"
+#include <vector>
+#include <cstdint>
+
+// Gaussian elimination on a SparseMatrix with Markowitz pivot ordering:
+// each step takes the pivot that minimises (row count - 1) * (column count - 1),
+// an upper bound on the fill-in it can create, searching only the few
+// shortest rows. Only rows holding the pivot column are touched.
+//
+// Instantiated for double, with threshold pivoting for stability, and for
+// int64_t, which stays exact by keeping every row primitive and throws
+// std::overflow_error when a value does not fit.
+template <typename T>
+class SparseEliminator {
+public:
+    // MatrixSolver switches to this engine below this density...
+    static constexpr double DEFAULT_DENSITY_THRESHOLD = 0.1;
+    // ...once the system is large enough for sparsity to pay off
+    static constexpr size_t MIN_COLUMNS = 64;
+
+    // Rows scanned per pivot search, shortest first
+    static constexpr size_t SEARCH_ROWS = 4;
+    // A double pivot must be at least this fraction of its row's largest entry
+    static constexpr double PIVOT_THRESHOLD = 0.1;
+
+private:
+    std::vector<SparseRow<T>> pivotRows_; // in elimination order
+    std::vector<int> pivotColumns_;
+    std::vector<int> freeColumns_;
+    size_t cols_ = 0;
+    size_t initialNonZeros_ = 0;
+    size_t peakNonZeros_ = 0;
+
+    static bool acceptable(const T& value, const T& rowMax);
+    static bool preferable(const T& value, const T& current);
+    // target -= (target[col] / pivot[col]) * pivot, written to result
+    static void combine(const SparseRow<T>& target, const SparseRow<T>& pivot, int col,
+                        const T& targetValue, const T& pivotValue, SparseRow<T>& result);
+
+public:
+    static bool prefers(const DenseMatrix<T>& matrix, double densityThreshold = DEFAULT_DENSITY_THRESHOLD) {
+        return matrix.cols() >= MIN_COLUMNS && densityOf(matrix) < densityThreshold;
+    }
+
+    // Eliminates the whole matrix, keeping each pivot row for back substitution
+    void factorize(SparseMatrix<T> matrix);
+
+    size_t rank() const { return pivotColumns_.size(); }
+    size_t nullity() const { return freeColumns_.size(); }
+    const std::vector<int>& freeColumns() const { return freeColumns_; }
+
+    // Null vector with the given free column set to 1 (double) or to the
+    // smallest positive value that keeps it integral (int64_t), and the
+    // other free columns set to 0
+    std::vector<T> nullVector(int freeColumn) const;
+    std::vector<std::vector<T>> nullspaceBasis() const;
+
+    // Fill-in statistics of the last factorization
+    size_t initialNonZeros() const { return initialNonZeros_; }
+    size_t peakNonZeros() const { return peakNonZeros_; }
+};
+
+#endif // SPARSE_ELIMINATOR_H
@@ -0,0 +1,97 @@
+#ifndef SPARSE_MATRIX_H
+#define SPARSE_MATRIX_H
+
+#include "DenseMatrix.h"
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+template <typename T>
+struct SparseEntry {
+    int col;
+    T value;
+};
+
+template <typename T>
+using SparseRow = std::vector<SparseEntry<T>>;
+
+// Row-wise sparse matrix: each row lists its non-zero entries sorted by
+// column. Rows grow and shrink independently, which is what elimination
+// with fill-in needs.
+template <typename T>
+class SparseMatrix {
+private:
+    std::vector<SparseRow<T>> rows_;
+    size_t cols_;
+
+public:
+    SparseMatrix() : cols_(0) {}
+    SparseMatrix(size_t rows, size_t cols) : rows_(rows), cols_(cols) {}
+
+    explicit SparseMatrix(const DenseMatrix<T>& dense) : rows_(dense.rows()), cols_(dense.cols()) {
+        for (size_t row = 0; row < dense.rows(); ++row) {
+            for (size_t col = 0; col < dense.cols(); ++col) {
+                if (dense(row, col) != T()) {
+                    rows_[row].push_back({static_cast<int>(col), dense(row, col)});
+                }
+            }
+        }
+    }
+
+    size_t rows() const { return rows_.size(); }
+    size_t cols() const { return cols_; }
+
+    size_t nonZeros() const {
+        size_t count = 0;
+        for (const auto& row : rows_) {
+            count += row.size();
+        }
+        return count;
+    }
+
+    double density() const {
+        return rows_.empty() || cols_ == 0 ? 0.0 : static_cast<double>(nonZeros()) / (rows_.size() * cols_);
+    }
+
+    // Inserts, overwrites or (for a zero value) removes one entry
+    void set(size_t row, int col, const T& value) {
+        SparseRow<T>& entries = rows_[row];
+        auto it = std::lower_bound(entries.begin(), entries.end(), col,
+                                   [](const SparseEntry<T>& entry, int column) { return entry.col < column; });
+        if (it != entries.end() && it->col == col) {
+            if (value == T()) {
+                entries.erase(it);
+            } else {
+                it->value = value;
+            }
+        } else if (value != T()) {
+            entries.insert(it, {col, value});
+        }
+    }
+
+    SparseRow<T>& row(size_t row) { return rows_[row]; }
+    const SparseRow<T>& row(size_t row) const { return rows_[row]; }
+
+    DenseMatrix<T> toDense() const {
+        DenseMatrix<T> dense(rows_.size(), cols_);
+        for (size_t row = 0; row < rows_.size(); ++row) {
+            for (const SparseEntry<T>& entry : rows_[row]) {
+                dense(row, entry.col) = entry.value;
+            }
+        }
+        return dense;
+    }
+};
+
+// Fraction of non-zero entries, 0 for an empty matrix
+template <typename T>
+double densityOf(const DenseMatrix<T>& matrix) {
+    if (matrix.empty()) {
+        return 0.0;
+    }
+    size_t size = matrix.rows() * matrix.cols();
+    size_t nonZeros = size - std::count(matrix.data(), matrix.data() + size, T());
+    return static_cast<double>(nonZeros) / size;
+}
+
+#endif // SPARSE_MATRIX_H
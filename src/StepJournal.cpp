@@ -0,0 +1,267 @@
+#include "StepJournal.h"
+#include "CheckedArithmetic.h"
+#include <sstream>
+#include <iomanip>
+
+// Largest magnitude below which every integer is a double
+static const int64_t EXACT_DOUBLE_LIMIT = int64_t(1) << 53;
+
+static bool fitsInDouble(const DenseMatrix<int64_t>& matrix, size_t begin, size_t end) {
+    for (size_t row = begin; row < end; ++row) {
+        for (int64_t value : matrix[row]) {
+            if (value > EXACT_DOUBLE_LIMIT || value < -EXACT_DOUBLE_LIMIT) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Same division as the solver's: by the content, negated when the first
+// non-zero entry, the row's pivot, is negative
+static void makePrimitive(std::vector<int64_t>& row) {
+    int64_t divisor = 0;
+    bool negative = false;
+    for (int64_t value : row) {
+        if (divisor == 0) {
+            negative = value < 0;
+        }
+        divisor = gcd64(divisor, value);
+    }
+    if (negative) {
+        divisor = -divisor;
+    }
+    if (divisor != 0 && divisor != 1) {
+        for (int64_t& value : row) {
+            value /= divisor;
+        }
+    }
+}
+
+static void readRow(const DenseMatrix<double>& matrix, size_t row, std::vector<int64_t>& values) {
+    values.resize(matrix.cols());
+    for (size_t j = 0; j < matrix.cols(); ++j) {
+        values[j] = static_cast<int64_t>(matrix(row, j));
+    }
+}
+
+static void writeRow(DenseMatrix<double>& matrix, size_t row, const std::vector<int64_t>& values) {
+    for (size_t j = 0; j < matrix.cols(); ++j) {
+        matrix(row, j) = static_cast<double>(values[j]);
+    }
+}
+
+// The solver's checked products fit in 64 bits, so these do as well
+static void replayBareissElimination(DenseMatrix<double>& matrix, int pivotRow, int column, int64_t previousPivot) {
+    std::vector<int64_t> pivot, target;
+    readRow(matrix, pivotRow, pivot);
+    for (size_t row = pivotRow + 1; row < matrix.rows(); ++row) {
+        readRow(matrix, row, target);
+        int64_t factor = target[column];
+        for (size_t j = column + 1; j < target.size(); ++j) {
+            target[j] = (pivot[column] * target[j] - factor * pivot[j]) / previousPivot;
+        }
+        target[column] = 0;
+        writeRow(matrix, row, target);
+    }
+}
+
+static void replayBareissClear(DenseMatrix<double>& matrix, int pivotRow, int column) {
+    // Rows are already primitive after the first clear, so this only does
+    // work when replaying that one
+    std::vector<int64_t> pivot, target;
+    for (size_t row = 0; row < matrix.rows(); ++row) {
+        readRow(matrix, row, target);
+        makePrimitive(target);
+        writeRow(matrix, row, target);
+    }
+
+    readRow(matrix, pivotRow, pivot);
+    for (int row = 0; row < pivotRow; ++row) {
+        readRow(matrix, row, target);
+        int64_t factor = target[column];
+        if (factor == 0) {
+            continue;
+        }
+        for (size_t j = 0; j < target.size(); ++j) {
+            target[j] = pivot[column] * target[j] - factor * pivot[j];
+        }
+        makePrimitive(target);
+        writeRow(matrix, row, target);
+    }
+}
+
+bool StepJournal::takesKeyframe(StepKind kind) {
+    // Unchanged steps replay as nothing, so they neither count towards the
+    // interval nor take a keyframe unless they open the journal
+    bool isOperation = kind != StepKind::SNAPSHOT && kind != StepKind::UNCHANGED;
+    if (keyframes_.empty() || kind == StepKind::SNAPSHOT || (isOperation && sinceKeyframe_ >= KEYFRAME_INTERVAL)) {
+        sinceKeyframe_ = 0;
+        return true;
+    }
+    if (isOperation) {
+        ++sinceKeyframe_;
+    }
+    return false;
+}
+
+void StepJournal::append(Entry entry, const DenseMatrix<double>& matrix) {
+    // Floating-point keyframes and updates may leave fractions behind
+    if (takesKeyframe(entry.kind)) {
+        keyframes_.push_back(matrix);
+        keyframeEntries_.push_back(entries_.size());
+        exact_ = false;
+    } else if (entry.kind == StepKind::ROW_SCALE || entry.kind == StepKind::ROW_ADD) {
+        exact_ = false;
+    }
+
+    entry.keyframe = keyframes_.size() - 1;
+    entries_.push_back(std::move(entry));
+}
+
+void StepJournal::append(Entry entry, const DenseMatrix<int64_t>& matrix) {
+    if (takesKeyframe(entry.kind)) {
+        keyframes_.emplace_back(matrix);
+        keyframeEntries_.push_back(entries_.size());
+        exact_ = fitsInDouble(matrix, 0, matrix.rows());
+    }
+
+    entry.keyframe = keyframes_.size() - 1;
+    entries_.push_back(std::move(entry));
+}
+
+void StepJournal::appendExact(Entry entry, const DenseMatrix<int64_t>& matrix, size_t begin, size_t end) {
+    if (!exact_ || !fitsInDouble(matrix, begin, end)) {
+        entry.description = describe(entry);
+        entry.operation = operationName(entry);
+        entry.kind = StepKind::SNAPSHOT;
+    }
+    append(std::move(entry), matrix);
+}
+
+void StepJournal::recordSnapshot(const std::string& description, const DenseMatrix<double>& matrix, const std::string& operation) {
+    append({StepKind::SNAPSHOT, 0, 0, 0.0, 0, 0, description, operation}, matrix);
+}
+
+void StepJournal::recordUnchanged(const std::string& description, const std::string& operation) {
+    append({StepKind::UNCHANGED, 0, 0, 0.0, 0, 0, description, operation}, DenseMatrix<double>());
+}
+
+void StepJournal::recordSwap(int row1, int row2, const DenseMatrix<double>& matrix) {
+    append({StepKind::ROW_SWAP, row1, row2, 0.0, 0, 0, "", ""}, matrix);
+}
+
+void StepJournal::recordScale(int row, double factor, const DenseMatrix<double>& matrix) {
+    append({StepKind::ROW_SCALE, row, row, factor, 0, 0, "", ""}, matrix);
+}
+
+void StepJournal::recordAdd(int sourceRow, int targetRow, double factor, const DenseMatrix<double>& matrix) {
+    append({StepKind::ROW_ADD, sourceRow, targetRow, factor, 0, 0, "", ""}, matrix);
+}
+
+void StepJournal::recordSnapshot(const std::string& description, const DenseMatrix<int64_t>& matrix, const std::string& operation) {
+    append({StepKind::SNAPSHOT, 0, 0, 0.0, 0, 0, description, operation}, matrix);
+}
+
+void StepJournal::recordSwap(int row1, int row2, const DenseMatrix<int64_t>& matrix) {
+    append({StepKind::ROW_SWAP, row1, row2, 0.0, 0, 0, "", ""}, matrix);
+}
+
+void StepJournal::recordBareissElimination(int pivotRow, int column, int64_t previousPivot, const DenseMatrix<int64_t>& matrix) {
+    appendExact({StepKind::BAREISS_ELIMINATION, pivotRow, column, 0.0, previousPivot, 0, "", ""}, matrix,
+                pivotRow + 1, matrix.rows());
+}
+
+void StepJournal::recordBareissClear(int pivotRow, int column, const DenseMatrix<int64_t>& matrix) {
+    // Dividing rows by their content only shrinks them, so only the cleared
+    // rows can have grown
+    appendExact({StepKind::BAREISS_CLEAR, pivotRow, column, 0.0, 0, 0, "", ""}, matrix, 0, pivotRow);
+}
+
+void StepJournal::clear() {
+    entries_.clear();
+    keyframes_.clear();
+    keyframeEntries_.clear();
+    sinceKeyframe_ = 0;
+    exact_ = false;
+}
+
+std::string StepJournal::describe(const Entry& entry) {
+    std::stringstream ss;
+    switch (entry.kind) {
+        case StepKind::ROW_SWAP:
+            ss << "Swap rows " << (entry.row1 + 1) << " and " << (entry.row2 + 1);
+            break;
+        case StepKind::ROW_SCALE:
+            ss << "Multiply row " << (entry.row1 + 1) << " by " << std::fixed << std::setprecision(3) << entry.factor;
+            break;
+        case StepKind::ROW_ADD:
+            ss << "Add " << std::fixed << std::setprecision(3) << entry.factor << " times row "
+               << (entry.row1 + 1) << " to row " << (entry.row2 + 1);
+            break;
+        case StepKind::BAREISS_ELIMINATION:
+            ss << "Eliminate column " << (entry.row2 + 1) << " below row " << (entry.row1 + 1)
+               << " (fraction-free, divided by " << entry.divisor << ")";
+            break;
+        case StepKind::BAREISS_CLEAR:
+            ss << "Clear column " << (entry.row2 + 1) << " above row " << (entry.row1 + 1);
+            break;
+        default:
+            return entry.description;
+    }
+    return ss.str();
+}
+
+std::string StepJournal::operationName(const Entry& entry) {
+    switch (entry.kind) {
+        case StepKind::ROW_SWAP: return "row_swap";
+        case StepKind::ROW_SCALE: return "row_scale";
+        case StepKind::ROW_ADD: return "row_add";
+        case StepKind::BAREISS_ELIMINATION: return "row_bareiss";
+        case StepKind::BAREISS_CLEAR: return "row_reduce";
+        default: return entry.operation;
+    }
+}
+
+std::string StepJournal::description(size_t index) const {
+    return describe(entries_[index]);
+}
+
+std::string StepJournal::operation(size_t index) const {
+    return operationName(entries_[index]);
+}
+
+DenseMatrix<double> StepJournal::matrixAt(size_t index) const {
+    size_t keyframe = entries_[index].keyframe;
+    DenseMatrix<double> matrix = keyframes_[keyframe];
+
+    // Same DenseMatrix row operations the solver ran, in the same order
+    for (size_t i = keyframeEntries_[keyframe] + 1; i <= index; ++i) {
+        const Entry& entry = entries_[i];
+        switch (entry.kind) {
+            case StepKind::ROW_SWAP:
+                matrix.swapRows(entry.row1, entry.row2);
+                break;
+            case StepKind::ROW_SCALE:
+                matrix.scaleRow(entry.row1, entry.factor);
+                break;
+            case StepKind::ROW_ADD:
+                matrix.addScaledRow(entry.row1, entry.row2, entry.factor);
+                break;
+            case StepKind::BAREISS_ELIMINATION:
+                replayBareissElimination(matrix, entry.row1, entry.row2, entry.divisor);
+                break;
+            case StepKind::BAREISS_CLEAR:
+                replayBareissClear(matrix, entry.row1, entry.row2);
+                break;
+            default:
+                break;
+        }
+    }
+
+    return matrix;
+}
+
+SolutionStep StepJournal::step(size_t index) const {
+    return {description(index), matrixAt(index), operation(index)};
+}
@@ -0,0 +1,99 @@
+#ifndef STEP_JOURNAL_H
+#define STEP_JOURNAL_H
+
+#include "DenseMatrix.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+struct SolutionStep {
+    std::string description;
+    DenseMatrix<double> matrix;
+    std::string operation;
+};
+
+enum class StepKind {
+    SNAPSHOT,   // the matrix is stored as a keyframe
+    UNCHANGED,  // same matrix as the previous step
+    ROW_SWAP,
+    ROW_SCALE,
+    ROW_ADD,
+    BAREISS_ELIMINATION, // fraction-free update of every row below a pivot
+    BAREISS_CLEAR        // column cleared above a pivot, rows kept primitive
+};
+
+// Journal of the solver's row operations. Elementary operations store only
+// their type, rows and factor; the matrix after any step is rebuilt on
+// demand by replaying operations from the nearest keyframe. A keyframe is
+// taken for every operation that cannot be replayed and after every
+// KEYFRAME_INTERVAL replayable ones, which bounds the replay cost.
+//
+// The exact solver's Bareiss steps replay in 64-bit integers. That is only
+// bit-identical while every stored value fits a double exactly, so a step
+// whose matrix holds a larger value is kept as a keyframe instead.
+class StepJournal {
+public:
+    static constexpr size_t KEYFRAME_INTERVAL = 32;
+
+private:
+    struct Entry {
+        StepKind kind;
+        int row1;       // swapped, scaled, source or Bareiss pivot row
+        int row2;       // swapped or target row, or Bareiss pivot column
+        double factor;
+        int64_t divisor; // previous pivot of a Bareiss elimination
+        size_t keyframe; // latest keyframe at or before this entry
+        std::string description; // only for SNAPSHOT and UNCHANGED, others are formatted on demand
+        std::string operation;
+    };
+
+    std::vector<Entry> entries_;
+    std::vector<DenseMatrix<double>> keyframes_;
+    std::vector<size_t> keyframeEntries_; // entry each keyframe was taken after
+    size_t sinceKeyframe_ = 0;
+    bool exact_ = false; // integer replay from here on reproduces the matrix
+
+    bool takesKeyframe(StepKind kind);
+    void append(Entry entry, const DenseMatrix<double>& matrix);
+    void append(Entry entry, const DenseMatrix<int64_t>& matrix);
+    // Appends a Bareiss step whose values changed in rows [begin, end), as a
+    // keyframe when replay would not be exact
+    void appendExact(Entry entry, const DenseMatrix<int64_t>& matrix, size_t begin, size_t end);
+    static std::string describe(const Entry& entry);
+    static std::string operationName(const Entry& entry);
+
+public:
+    // Record calls take the matrix as it is after the operation; it is only
+    // copied when a keyframe is due
+    void recordSnapshot(const std::string& description, const DenseMatrix<double>& matrix, const std::string& operation);
+    void recordUnchanged(const std::string& description, const std::string& operation);
+    void recordSwap(int row1, int row2, const DenseMatrix<double>& matrix);
+    void recordScale(int row, double factor, const DenseMatrix<double>& matrix);
+    void recordAdd(int sourceRow, int targetRow, double factor, const DenseMatrix<double>& matrix);
+
+    // Exact solver counterparts; the matrix is only converted for a keyframe
+    void recordSnapshot(const std::string& description, const DenseMatrix<int64_t>& matrix, const std::string& operation);
+    void recordSwap(int row1, int row2, const DenseMatrix<int64_t>& matrix);
+    // Every row below pivotRow became (pivot * row - row[column] * pivot row)
+    // / previousPivot
+    void recordBareissElimination(int pivotRow, int column, int64_t previousPivot, const DenseMatrix<int64_t>& matrix);
+    // Every row was divided by its content with its pivot made positive, and
+    // each row above pivotRow with a non-zero entry in column became
+    // pivot * row - row[column] * pivot row, again made primitive
+    void recordBareissClear(int pivotRow, int column, const DenseMatrix<int64_t>& matrix);
+
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+    size_t keyframeCount() const { return keyframes_.size(); }
+    void clear();
+
+    StepKind kind(size_t index) const { return entries_[index].kind; }
+    std::string description(size_t index) const;
+    std::string operation(size_t index) const;
+
+    // Bit-identical to the matrix the solver held after this step
+    DenseMatrix<double> matrixAt(size_t index) const;
+    SolutionStep step(size_t index) const;
+};
+
+#endif // STEP_JOURNAL_H
@@ -56,7 +56,7 @@ MolarRatio StoichiometryCalculator::calculateMolarRatios(const ChemicalEquation&
 std::vector<StoichiometricRelation> StoichiometryCalculator::calculateAllRelations(const ChemicalEquation& equation) {
     std::vector<StoichiometricRelation> relations;
     
-    std::vector<std::pair<ChemicalCompound, int>> allCompounds;
+    std::vector<std::pair<ChemicalCompound, int64_t>> allCompounds;
     
     // Collect all compounds
     for (const auto& reactant : equation.getReactants()) {
@@ -164,8 +164,8 @@ double StoichiometryCalculator::calculateTheoreticalYield(
     double limitingReagentAmount) {
     
     // Find coefficients
-    int limitingCoeff = 0;
-    int productCoeff = 0;
+    int64_t limitingCoeff = 0;
+    int64_t productCoeff = 0;
     ChemicalCompound productCompound("");
     
     for (const auto& reactant : equation.getReactants()) {
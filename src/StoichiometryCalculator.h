@@ -7,7 +7,7 @@
 #include <vector>
 
 struct MolarRatio {
-    std::map<std::string, int> ratios; // compound formula -> molar ratio
+    std::map<std::string, int64_t> ratios; // compound formula -> molar ratio
     std::string description;
 };
 
@@ -0,0 +1,143 @@
+#include "TermCache.h"
+#include "EquationBalancer.h"
+#include "EquationTokenizer.h"
+#include "FormulaCache.h"
+
+TermCache::TermCache() : lastReparsed_(0) {}
+
+ParsedTerm TermCache::parseTerm(std::string_view text, size_t offset) {
+    EquationTokenizer tokenizer(text);
+    Token token = tokenizer.next();
+    size_t formulaStart = 0;
+    size_t formulaLength = text.size();
+    int coefficient = 1;
+    ParseDiagnostic diagnostic = EquationBalancer::parseTerm(tokenizer, token, formulaStart, formulaLength, coefficient);
+    
+    // The side was split at '+', so anything left over is an arrow or stray text
+    if (diagnostic.ok() && token.type != TokenType::END) {
+        diagnostic = {ParseStatus::INVALID_TERM, token.position, "Unexpected text after formula"};
+    }
+    
+    // Half-typed terms stay out of the shared cache; their compound is an
+    // empty placeholder, since an equation is only built once all terms parse
+    ChemicalCompound compound{std::string_view()};
+    if (diagnostic.ok()) {
+        compound = FormulaCache::getInstance().intern(text.substr(formulaStart, formulaLength));
+        diagnostic = compound.getParseDiagnostic();
+        diagnostic.position += formulaStart;
+    }
+    
+    std::string display(text);
+    if (diagnostic.ok()) {
+        display = compound.getDisplayFormula();
+        if (coefficient != 1) {
+            display = std::to_string(coefficient) + display;
+        }
+    } else {
+        diagnostic.position += offset;
+    }
+    
+    return {std::string(text), offset, coefficient, compound, display, diagnostic};
+}
+
+size_t TermCache::update(std::string_view sideText) {
+    // Split at '+' and trim, skipping empty terms like parseEquation does
+    std::vector<std::pair<size_t, std::string_view>> pieces;
+    size_t start = 0;
+    while (start <= sideText.size()) {
+        size_t end = sideText.find('+', start);
+        if (end == std::string_view::npos) {
+            end = sideText.size();
+        }
+        
+        size_t first = start;
+        size_t last = end;
+        while (first < last && EquationTokenizer::isWhitespace(sideText[first])) {
+            ++first;
+        }
+        while (last > first && EquationTokenizer::isWhitespace(sideText[last - 1])) {
+            --last;
+        }
+        if (last > first) {
+            pieces.push_back({first, sideText.substr(first, last - first)});
+        }
+        
+        start = end + 1;
+    }
+    
+    // Terms unchanged at the front and at the back keep their parse
+    size_t prefix = 0;
+    while (prefix < pieces.size() && prefix < terms_.size() && terms_[prefix].text == pieces[prefix].second) {
+        ++prefix;
+    }
+    size_t suffix = 0;
+    while (suffix < pieces.size() - prefix && suffix < terms_.size() - prefix &&
+           terms_[terms_.size() - 1 - suffix].text == pieces[pieces.size() - 1 - suffix].second) {
+        ++suffix;
+    }
+    
+    lastReparsed_ = 0;
+    auto moveTerm = [&](ParsedTerm& term, size_t offset) {
+        if (!term.diagnostic.ok()) {
+            term.diagnostic.position = term.diagnostic.position - term.offset + offset;
+        }
+        term.offset = offset;
+    };
+    
+    // Editing inside a term keeps the term count, update in place
+    if (pieces.size() == terms_.size()) {
+        for (size_t i = 0; i < pieces.size(); ++i) {
+            if (i < prefix || i >= pieces.size() - suffix) {
+                moveTerm(terms_[i], pieces[i].first);
+            } else {
+                terms_[i] = parseTerm(pieces[i].second, pieces[i].first);
+                ++lastReparsed_;
+            }
+        }
+        return lastReparsed_;
+    }
+    
+    std::vector<ParsedTerm> terms;
+    terms.reserve(pieces.size());
+    
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        if (i < prefix || i >= pieces.size() - suffix) {
+            size_t old = i < prefix ? i : terms_.size() - (pieces.size() - i);
+            terms.push_back(std::move(terms_[old]));
+            moveTerm(terms.back(), pieces[i].first);
+        } else {
+            terms.push_back(parseTerm(pieces[i].second, pieces[i].first));
+            ++lastReparsed_;
+        }
+    }
+    
+    terms_ = std::move(terms);
+    return lastReparsed_;
+}
+
+void TermCache::clear() {
+    terms_.clear();
+    lastReparsed_ = 0;
+}
+
+bool TermCache::isValid() const {
+    return !terms_.empty() && firstError() == nullptr;
+}
+
+const ParsedTerm* TermCache::firstError() const {
+    for (const ParsedTerm& term : terms_) {
+        if (!term.diagnostic.ok()) {
+            return &term;
+        }
+    }
+    return nullptr;
+}
+
+std::string TermCache::toDisplayString() const {
+    std::string display;
+    for (size_t i = 0; i < terms_.size(); ++i) {
+        if (i > 0) display += " + ";
+        display += terms_[i].display;
+    }
+    return display;
+}
@@ -0,0 +1,48 @@
+#ifndef TERM_CACHE_H
+#define TERM_CACHE_H
+
+#include "ChemicalCompound.h"
+#include "ParseDiagnostic.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct ParsedTerm {
+    std::string text;            // term as typed, without surrounding whitespace
+    size_t offset;               // of the term in the side text
+    int coefficient;
+    ChemicalCompound compound;
+    std::string display;         // coefficient and formula with subscripts
+    ParseDiagnostic diagnostic;  // positions relative to the side text
+};
+
+// Parsed terms of one side of an equation ("H2 + O2"), kept between edits.
+// On update the side is split at '+' and aligned with the previous terms
+// from both ends, so typing inside one term re-parses only that term and
+// inserting or deleting a term leaves its neighbours untouched.
+class TermCache {
+private:
+    std::vector<ParsedTerm> terms_;
+    size_t lastReparsed_;
+    
+    static ParsedTerm parseTerm(std::string_view text, size_t offset);
+    
+public:
+    TermCache();
+    
+    // Returns the number of terms that had to be parsed
+    size_t update(std::string_view sideText);
+    void clear();
+    
+    const std::vector<ParsedTerm>& terms() const { return terms_; }
+    size_t lastReparsed() const { return lastReparsed_; }
+    
+    bool empty() const { return terms_.empty(); }
+    bool isValid() const;
+    // First failing term, or nullptr when every term parsed
+    const ParsedTerm* firstError() const;
+    
+    std::string toDisplayString() const; // "2H₂ + O₂"
+};
+
+#endif // TERM_CACHE_H
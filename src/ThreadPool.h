@@ -0,0 +1,49 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <cstddef>
+
+// Fixed set of worker threads for data-parallel loops. Workers sleep
+// between jobs, so a solver can hand out one job per elimination step
+// without paying for thread creation each time.
+class ThreadPool {
+private:
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable finished_;
+    std::mutex jobMutex_; // one parallelFor at a time
+
+    const std::function<void(size_t)>* task_;
+    size_t count_;
+    std::atomic<size_t> next_;
+    size_t busy_;
+    size_t generation_;
+    bool stopping_;
+
+    void workerLoop();
+    void runTasks();
+
+public:
+    // threads counts the calling thread, so 1 starts no workers
+    explicit ThreadPool(size_t threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers_.size() + 1; }
+
+    // Runs task(i) for every i < count and returns when all are done. The
+    // calling thread takes part; indices are handed out in order but may
+    // finish in any order, so tasks must be independent and must not throw.
+    void parallelFor(size_t count, const std::function<void(size_t)>& task);
+};
+
+#endif // THREAD_POOL_H
@@ -216,6 +216,14 @@ void processEquation(const std::string& equationStr) {
                 }
             }
             
+        } else if (result.result == BalanceResult::COEFFICIENT_OVERFLOW && !result.largeCoefficients.empty()) {
+            std::cout << "⚠️ " << result.message << "\n\n";
+            std::cout << "Coefficients: ";
+            for (size_t i = 0; i < result.largeCoefficients.size(); ++i) {
+                if (i > 0) std::cout << ", ";
+                std::cout << result.largeCoefficients[i].toString();
+            }
+            std::cout << "\n";
         } else {
             std::cout << "❌ FAILED!\n";
             std::cout << "Error: " << result.message << "\n";
@@ -0,0 +1,1309 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <regex>
+#include <functional>
+#include "ChemicalCompound.h"
+#include "EquationBalancer.h"
+#include "EquationTokenizer.h"
+#include "CompoundDatabase.h"
+#include "FormulaCache.h"
+#include "FormulaScanner.h"
+#include "TermCache.h"
+#include "SparseEliminator.h"
+#include "RowKernels.h"
+#include "MultiModularSolver.h"
+#include "BatchSolver.h"
+#include "LatticeSolver.h"
+#include "MixedPrecisionSolver.h"
+#include "CheckedArithmetic.h"
+#include <thread>
+#include <random>
+#include <stdexcept>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <limits>
+#include <algorithm>
+#include <cstring>
+
+// Every heap allocation in the process is counted, so benchmarks can report
+// allocations per iteration next to their timings
+static std::atomic<size_t> allocationCount{0};
+
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+// Kept out of line: once inlined next to operator new, GCC reports the
+// malloc/free pairing as mismatched
+__attribute__((noinline)) void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+__attribute__((noinline)) void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+struct BenchmarkResult {
+    std::string name;
+    double seconds;
+    size_t iterations;
+    size_t bytes;
+};
+
+// Repeats body until at least minSeconds have elapsed
+BenchmarkResult runTimed(const std::string& name, size_t bytesPerIteration,
+                         const std::function<void()>& body, double minSeconds = 0.25) {
+    // Warm up caches and the database singleton
+    body();
+
+    size_t iterations = 0;
+    double seconds = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    while (seconds < minSeconds) {
+        body();
+        ++iterations;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    return {name, seconds, iterations, bytesPerIteration * iterations};
+}
+
+void printResult(const BenchmarkResult& result) {
+    double perIteration = result.seconds * 1e6 / result.iterations;
+    double megabytesPerSecond = result.bytes / result.seconds / (1024.0 * 1024.0);
+
+    std::cout << "  " << std::left << std::setw(36) << result.name << std::right
+              << std::fixed << std::setprecision(3) << std::setw(10) << perIteration << " us/iter"
+              << std::setprecision(2) << std::setw(10) << megabytesPerSecond << " MB/s\n";
+}
+
+void printUsage(const std::string& programName) {
+    std::cout << "Usage: " << programName << " [benchmark]\n";
+    std::cout << "\nBenchmarks:\n";
+    std::cout << "  parse       Equation parsing throughput (tokenizer vs regex)\n";
+    std::cout << "  cache       Formula intern cache vs direct parsing\n";
+    std::cout << "  validate    Bulk formula validation (scanner vs parser)\n";
+    std::cout << "  incremental Per-keystroke re-parse of a 30-species equation\n";
+    std::cout << "  solver      Exact Bareiss vs floating-point elimination, 5-200 species\n";
+    std::cout << "  matrix      Contiguous vs nested-vector matrices on 50x100 systems\n";
+    std::cout << "  steps       Solver cost with step recording on and off\n";
+    std::cout << "  rank        Scratch-buffer rank pre-check vs explained elimination\n";
+    std::cout << "  sparse      Markowitz sparse vs dense elimination, 100-10k species\n";
+    std::cout << "  kernels     Row scale, axpy and pivot search per SIMD level, widths 8-4096\n";
+    std::cout << "  modular     Multi-modular CRT vs Bareiss and floating point, 20-160 elements\n";
+    std::cout << "  checked     Overflow checks on coefficient sums, 64-bit, 128-bit and BigInteger\n";
+    std::cout << "  small       p50/p99 balance latency, stack-allocated solver vs generic, 3-8 species\n";
+    std::cout << "  batch       SIMD-lane batch solver vs one system at a time, 64k small systems\n";
+    std::cout << "  lattice     Smallest positive solution search, nullity 2-10, three budgets\n";
+    std::cout << "  blocked     Blocked parallel elimination and nullspace vs row at a time, up to 2000x5000, 1-64 threads\n";
+    std::cout << "  mixed       Verified float/double nullspace vs exact and unverified floating point, 5-100 species\n";
+    std::cout << "  all         Run every benchmark (default)\n";
+}
+
+// Regex based splitting as it was done before EquationTokenizer, kept
+// here only as the reference for the parse benchmark
+size_t regexTokenize(const std::string& equationStr) {
+    size_t count = 0;
+
+    std::regex arrowRegex(R"(\s*(?:->|→)\s*)");
+    std::sregex_token_iterator sideIter(equationStr.begin(), equationStr.end(), arrowRegex, -1);
+    std::sregex_token_iterator end;
+
+    for (; sideIter != end; ++sideIter) {
+        std::string side = *sideIter;
+
+        std::regex plusRegex(R"(\s*\+\s*)");
+        std::sregex_token_iterator termIter(side.begin(), side.end(), plusRegex, -1);
+        for (; termIter != end; ++termIter) {
+            std::string term = *termIter;
+            if (term.empty()) continue;
+
+            std::regex coeffRegex(R"(^\s*(\d+)?\s*([A-Za-z0-9()]+)\s*$)");
+            std::smatch match;
+            if (std::regex_match(term, match, coeffRegex)) {
+                std::string formula = match[2].str();
+
+                std::regex stateRegex(R"(\s*\([slgaq]\)\s*)");
+                formula = std::regex_replace(formula, stateRegex, "");
+                std::regex spaceRegex(R"(\s+)");
+                formula = std::regex_replace(formula, spaceRegex, "");
+
+                count += formula.size();
+            }
+        }
+    }
+
+    return count;
+}
+
+size_t scannerTokenize(const std::string& equationStr) {
+    size_t count = 0;
+    EquationTokenizer tokenizer(equationStr);
+
+    for (Token token = tokenizer.next(); token.type != TokenType::END; token = tokenizer.next()) {
+        if (token.type == TokenType::FORMULA) {
+            count += EquationTokenizer::cleanFormula(token.text).size();
+        }
+    }
+
+    return count;
+}
+
+void benchmarkParsing() {
+    std::cout << "=== Parse throughput ===\n";
+
+    std::vector<std::string> corpus = {
+        "H2 + O2 -> H2O",
+        "CH4 + O2 -> CO2 + H2O",
+        "C6H12O6 + O2 -> CO2 + H2O",
+        "2 Fe(s) + 3 O2(g) → Fe2O3(s)",
+        "Ca(OH)2 + H3PO4 -> Ca3(PO4)2 + H2O",
+        "KMnO4 + HCl -> KCl + MnCl2 + H2O + Cl2",
+        "NaCl(aq) + AgNO3(aq) -> AgCl(s) + NaNO3(aq)",
+        "K4Fe(CN)6 + KMnO4 + H2SO4 -> KHSO4 + Fe2(SO4)3 + MnSO4 + HNO3 + CO2 + H2O"
+    };
+
+    size_t corpusBytes = 0;
+    for (const auto& eq : corpus) {
+        corpusBytes += eq.size();
+    }
+
+    volatile size_t sink = 0;
+
+    printResult(runTimed("tokenize (regex)", corpusBytes, [&]() {
+        for (const auto& eq : corpus) sink = sink + regexTokenize(eq);
+    }));
+
+    printResult(runTimed("tokenize (EquationTokenizer)", corpusBytes, [&]() {
+        for (const auto& eq : corpus) sink = sink + scannerTokenize(eq);
+    }));
+
+    printResult(runTimed("parseEquationString", corpusBytes, [&]() {
+        for (const auto& eq : corpus) {
+            sink = sink + EquationBalancer::parseEquationString(eq).getTotalCompounds();
+        }
+    }));
+
+    std::string buffer;
+    for (const auto& eq : corpus) {
+        buffer += eq + "\n";
+    }
+
+    printResult(runTimed("parseEquationLines (in place)", corpusBytes, [&]() {
+        sink = sink + EquationBalancer::parseEquationLines(buffer).equations.size();
+    }));
+
+    std::cout << "\n";
+}
+
+void benchmarkFormulaCache() {
+    std::cout << "=== Formula intern cache ===\n";
+
+    std::vector<std::string> species = {
+        "H2O", "O2", "CO2", "H2", "N2", "NH3", "CH4", "C2H6", "C3H8", "C6H12O6",
+        "NaCl", "HCl", "NaOH", "Ca(OH)2", "CaCO3", "H2SO4", "Fe2O3", "Al2(SO4)3",
+        "KMnO4", "K4Fe(CN)6", "Ca3(PO4)2", "NaNO3", "AgNO3", "MgSO4"
+    };
+
+    size_t speciesBytes = 0;
+    for (const auto& formula : species) {
+        speciesBytes += formula.size();
+    }
+
+    FormulaCache& cache = FormulaCache::getInstance();
+    cache.clear();
+    volatile double sink = 0.0;
+
+    printResult(runTimed("ChemicalCompound (uncached)", speciesBytes, [&]() {
+        for (const auto& formula : species) sink = sink + ChemicalCompound(formula).getMolarMass();
+    }));
+
+    printResult(runTimed("FormulaCache::intern", speciesBytes, [&]() {
+        for (const auto& formula : species) sink = sink + cache.intern(formula).getMolarMass();
+    }));
+
+    unsigned threadCount = std::max(2u, std::thread::hardware_concurrency());
+    printResult(runTimed("intern, " + std::to_string(threadCount) + " threads", speciesBytes * threadCount * 100, [&]() {
+        std::vector<std::thread> threads;
+        for (unsigned t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&]() {
+                double local = 0.0;
+                for (int repeat = 0; repeat < 100; ++repeat) {
+                    for (const auto& formula : species) local += cache.intern(formula).getMolarMass();
+                }
+                sink = sink + local;
+            });
+        }
+        for (auto& thread : threads) thread.join();
+    }));
+
+    FormulaCacheStats stats = cache.getStats();
+    std::cout << "  hits: " << stats.hits << ", misses: " << stats.misses
+              << ", evictions: " << stats.evictions << ", size: " << stats.size << "\n\n";
+}
+
+void benchmarkValidation() {
+    std::cout << "=== Bulk formula validation (" << (FormulaScanner::usesAvx2() ? "AVX2" : "portable") << ") ===\n";
+
+    std::vector<std::string> shortFormulas = {
+        "H2O", "CO2", "C6H12O6", "NaCl", "Ca(OH)2", "Al2(SO4)3", "K4Fe(CN)6", "Ca3(PO4)2",
+        "CH3COOH", "NH4NO3", "Mg(OH)2", "Fe2O3", "CuSO4", "KMnO4", "C8H18", "H2SO4"
+    };
+
+    // Polymer-like formulas from repeated units, a few hundred bytes each
+    std::vector<std::string> longFormulas;
+    for (const auto& unit : {"CH2", "C2H4O", "(C6H10O5)", "Si(CH3)2O", "CF2"}) {
+        std::string formula;
+        for (int repeat = 0; repeat < 64; ++repeat) formula += unit;
+        longFormulas.push_back(formula);
+    }
+
+    auto run = [](const std::string& label, const std::vector<std::string>& formulas) {
+        size_t bytes = 0;
+        for (const auto& formula : formulas) bytes += formula.size();
+        volatile size_t sink = 0;
+
+        printResult(runTimed("ChemicalCompound, " + label, bytes, [&]() {
+            for (const auto& formula : formulas) sink = sink + ChemicalCompound(formula).isValid();
+        }));
+
+        printResult(runTimed("FormulaScanner::validate, " + label, bytes, [&]() {
+            for (const auto& formula : formulas) sink = sink + FormulaScanner::validate(formula).ok();
+        }));
+    };
+
+    run("short", shortFormulas);
+    run("long", longFormulas);
+    std::cout << "\n";
+}
+
+void benchmarkIncremental() {
+    std::cout << "=== Incremental term parsing (30 species) ===\n";
+
+    std::string reactants = "C6H12O6 + O2 + NH3 + H2SO4 + NaOH + KMnO4 + HCl + Fe2O3 + Al + CaCO3 + "
+                            "Ca(OH)2 + H3PO4 + CuSO4 + Mg + Na2CO3";
+    std::string products = "CO2 + H2O + NO + Na2SO4 + MnCl2 + KCl + Cl2 + FeCl3 + Al2O3 + CaCl2 + "
+                           "Ca3(PO4)2 + Cu + MgO + NaCl + N2";
+
+    // Alternates the last term between two spellings, as if a key was typed and deleted
+    std::string edited = reactants.substr(0, reactants.size() - 2) + "C";
+    size_t bytes = reactants.size() + products.size();
+    bool flip = false;
+
+    EquationBalancer balancer;
+    volatile size_t sink = 0;
+
+    printResult(runTimed("full re-parse (parseEquation)", bytes, [&]() {
+        flip = !flip;
+        ChemicalEquation equation;
+        EquationBalancer::parseEquation((flip ? edited : reactants) + " -> " + products, equation);
+        sink = sink + equation.getTotalCompounds();
+    }));
+
+    TermCache reactantTerms;
+    TermCache productTerms;
+    productTerms.update(products);
+
+    auto buildEquation = [&]() {
+        ChemicalEquation equation;
+        for (const ParsedTerm& term : reactantTerms.terms()) equation.addReactant(term.compound, term.coefficient);
+        for (const ParsedTerm& term : productTerms.terms()) equation.addProduct(term.compound, term.coefficient);
+        return equation;
+    };
+
+    printResult(runTimed("TermCache::update, one term edited", bytes, [&]() {
+        flip = !flip;
+        sink = sink + reactantTerms.update(flip ? edited : reactants);
+        sink = sink + buildEquation().getTotalCompounds();
+    }));
+
+    printResult(runTimed("TermCache::update + live balance", bytes, [&]() {
+        flip = !flip;
+        reactantTerms.update(flip ? edited : reactants);
+        ChemicalEquation equation = buildEquation();
+        sink = sink + balancer.balance(equation).coefficients.size();
+    }));
+
+    std::cout << "\n";
+}
+
+// Random sparse stoichiometric matrix: species-1 elements, each species made
+// of three elements with small counts, products negated
+DenseMatrix<int64_t> makeStoichiometry(int species, unsigned seed) {
+    std::mt19937 rng(seed);
+    int elements = species - 1;
+    DenseMatrix<int64_t> matrix(elements, species, 0);
+
+    for (int col = 0; col < species; ++col) {
+        for (int k = 0; k < 3; ++k) {
+            int64_t count = 1 + rng() % 4;
+            matrix[rng() % elements][col] = col < species / 2 ? count : -count;
+        }
+    }
+    return matrix;
+}
+
+bool isNullVector(const DenseMatrix<int64_t>& matrix, const std::vector<int64_t>& solution) {
+    bool nonZero = false;
+    for (int64_t value : solution) nonZero = nonZero || value != 0;
+    if (!nonZero || solution.size() != matrix.cols()) return false;
+
+    for (size_t row = 0; row < matrix.rows(); ++row) {
+        long double sum = 0;
+        for (size_t col = 0; col < matrix.cols(); ++col) sum += static_cast<long double>(matrix(row, col)) * solution[col];
+        if (sum != 0) return false;
+    }
+    return true;
+}
+
+void benchmarkSolver() {
+    std::cout << "=== Exact (Bareiss) vs floating-point elimination ===\n";
+
+    const int SAMPLES = 8;
+
+    for (int species : {5, 10, 20, 50, 100, 200}) {
+        std::vector<DenseMatrix<int64_t>> systems;
+        for (int sample = 0; sample < SAMPLES; ++sample) {
+            systems.push_back(makeStoichiometry(species, 1000 * species + sample));
+        }
+        size_t bytes = SAMPLES * (species - 1) * species * sizeof(int64_t);
+
+        // Step snapshots would dominate both paths, see the "steps" benchmark
+        MatrixSolver solver;
+        solver.setRecordSteps(false);
+        int exactCorrect = 0;
+        int overflows = 0;
+        printResult(runTimed(std::to_string(species) + " species, exact", bytes, [&]() {
+            exactCorrect = 0;
+            overflows = 0;
+            for (const auto& system : systems) {
+                auto matrix = system;
+                try {
+                    exactCorrect += isNullVector(system, solver.bareissElimination(matrix));
+                } catch (const std::overflow_error&) {
+                    ++overflows;
+                }
+            }
+        }));
+
+        int floatingCorrect = 0;
+        printResult(runTimed(std::to_string(species) + " species, floating point", bytes, [&]() {
+            floatingCorrect = 0;
+            for (const auto& system : systems) {
+                DenseMatrix<double> matrix(system);
+                std::vector<int64_t> coefficients = solver.reduceToIntegers(solver.gaussianElimination(matrix));
+                floatingCorrect += isNullVector(system, std::vector<int64_t>(coefficients.begin(), coefficients.end()));
+            }
+        }));
+
+        std::cout << "    correct null vectors: exact " << exactCorrect << "/" << SAMPLES;
+        if (overflows) std::cout << " (" << overflows << " overflowed 64 bits)";
+        std::cout << ", floating point " << floatingCorrect << "/" << SAMPLES << "\n";
+    }
+
+    std::cout << "\n";
+}
+
+using NestedMatrix = std::vector<std::vector<double>>;
+
+size_t rowCount(const NestedMatrix& matrix) { return matrix.size(); }
+size_t rowCount(const DenseMatrix<double>& matrix) { return matrix.rows(); }
+
+// Partial-pivoting forward elimination written once for both layouts, with
+// an optional snapshot after every row operation as MatrixSolver records
+template <typename Matrix>
+double eliminate(Matrix& matrix, std::vector<Matrix>* snapshots) {
+    size_t rows = rowCount(matrix);
+    size_t cols = matrix[0].size();
+
+    for (size_t pivot = 0; pivot < std::min(rows, cols); ++pivot) {
+        size_t pivotRow = pivot;
+        for (size_t row = pivot + 1; row < rows; ++row) {
+            if (std::abs(matrix[row][pivot]) > std::abs(matrix[pivotRow][pivot])) pivotRow = row;
+        }
+        if (std::abs(matrix[pivotRow][pivot]) < 1e-10) continue;
+        for (size_t col = 0; col < cols; ++col) std::swap(matrix[pivot][col], matrix[pivotRow][col]);
+
+        for (size_t row = pivot + 1; row < rows; ++row) {
+            double factor = -matrix[row][pivot] / matrix[pivot][pivot];
+            for (size_t col = 0; col < cols; ++col) matrix[row][col] += factor * matrix[pivot][col];
+            if (snapshots) snapshots->push_back(matrix);
+        }
+    }
+    return matrix[rows - 1][cols - 1];
+}
+
+void benchmarkMatrix() {
+    std::cout << "=== Contiguous vs nested-vector matrix, 50x100 ===\n";
+
+    const size_t ROWS = 50;
+    const size_t COLS = 100;
+
+    std::mt19937 rng(50100);
+    DenseMatrix<double> dense(ROWS, COLS);
+    NestedMatrix nested(ROWS, std::vector<double>(COLS));
+    for (size_t row = 0; row < ROWS; ++row) {
+        for (size_t col = 0; col < COLS; ++col) {
+            double value = static_cast<int>(rng() % 9) - 4;
+            dense(row, col) = value;
+            nested[row][col] = value;
+        }
+    }
+    size_t bytes = ROWS * COLS * sizeof(double);
+
+    // Runs body once more outside the timing to count its allocations
+    auto report = [](const BenchmarkResult& result, const std::function<void()>& body) {
+        size_t before = allocationCount.load();
+        body();
+        size_t allocations = allocationCount.load() - before;
+        printResult(result);
+        std::cout << "    " << allocations << " allocations per iteration\n";
+    };
+
+    volatile double sink = 0;
+
+    std::function<void()> copyNested = [&]() { NestedMatrix copy = nested; sink = sink + copy[0][0]; };
+    std::function<void()> copyDense = [&]() { DenseMatrix<double> copy = dense; sink = sink + copy(0, 0); };
+    report(runTimed("copy, nested vectors", bytes, copyNested), copyNested);
+    report(runTimed("copy, contiguous", bytes, copyDense), copyDense);
+
+    std::function<void()> eliminateNested = [&]() { NestedMatrix copy = nested; sink = sink + eliminate(copy, static_cast<std::vector<NestedMatrix>*>(nullptr)); };
+    std::function<void()> eliminateDense = [&]() { DenseMatrix<double> copy = dense; sink = sink + eliminate(copy, static_cast<std::vector<DenseMatrix<double>>*>(nullptr)); };
+    report(runTimed("elimination, nested vectors", bytes, eliminateNested), eliminateNested);
+    report(runTimed("elimination, contiguous", bytes, eliminateDense), eliminateDense);
+
+    std::function<void()> recordNested = [&]() {
+        NestedMatrix copy = nested;
+        std::vector<NestedMatrix> snapshots;
+        sink = sink + eliminate(copy, &snapshots);
+    };
+    std::function<void()> recordDense = [&]() {
+        DenseMatrix<double> copy = dense;
+        std::vector<DenseMatrix<double>> snapshots;
+        sink = sink + eliminate(copy, &snapshots);
+    };
+    report(runTimed("elimination + steps, nested vectors", bytes, recordNested), recordNested);
+    report(runTimed("elimination + steps, contiguous", bytes, recordDense), recordDense);
+
+    MatrixSolver solver;
+    std::function<void()> solve = [&]() { DenseMatrix<double> copy = dense; sink = sink + solver.gaussianElimination(copy).size(); };
+    report(runTimed("MatrixSolver::gaussianElimination", bytes, solve), solve);
+
+    std::cout << "\n";
+}
+
+void benchmarkSteps() {
+    std::cout << "=== Step recording on vs off ===\n";
+
+    for (int species : {20, 50, 100}) {
+        DenseMatrix<int64_t> system = makeStoichiometry(species, species);
+        DenseMatrix<double> matrix(system);
+        size_t bytes = matrix.rows() * matrix.cols() * sizeof(double);
+
+        for (bool record : {true, false}) {
+            MatrixSolver solver;
+            solver.setRecordSteps(record);
+            volatile size_t sink = 0;
+            std::string label = std::to_string(species) + " species, " + (record ? "recorded" : "not recorded");
+            printResult(runTimed(label + ", floating", bytes, [&]() {
+                DenseMatrix<double> copy = matrix;
+                sink = sink + solver.gaussianElimination(copy).size();
+            }));
+            printResult(runTimed(label + ", exact", bytes, [&]() {
+                DenseMatrix<int64_t> copy = system;
+                try {
+                    sink = sink + solver.nullspaceBasis(copy).size();
+                } catch (const std::overflow_error&) {
+                }
+            }));
+        }
+
+        MatrixSolver solver;
+        DenseMatrix<double> copy = matrix;
+        solver.gaussianElimination(copy);
+        const StepJournal& journal = solver.getSteps();
+        std::cout << "    journal: " << journal.size() << " steps, " << journal.keyframeCount() << " keyframes, "
+                  << journal.keyframeCount() * bytes / 1024 << " KiB of matrices vs "
+                  << journal.size() * bytes / 1024 << " KiB as one snapshot per step\n";
+    }
+
+    std::cout << "\n";
+}
+
+void benchmarkRank() {
+    std::cout << "=== Rank pre-check vs explained elimination, 50x100 ===\n";
+
+    std::mt19937 rng(50100);
+    DenseMatrix<double> matrix(50, 100);
+    for (size_t i = 0; i < matrix.rows() * matrix.cols(); ++i) {
+        matrix.data()[i] = static_cast<int>(rng() % 9) - 4;
+    }
+    size_t bytes = matrix.rows() * matrix.cols() * sizeof(double);
+
+    MatrixSolver solver;
+    volatile int sink = 0;
+
+    std::function<void()> explained = [&]() {
+        DenseMatrix<double> copy = matrix;
+        sink = sink + static_cast<int>(solver.gaussianElimination(copy).size());
+    };
+    std::function<void()> precheck = [&]() { sink = sink + solver.nullity(matrix); };
+
+    for (const auto& benchmark : {std::make_pair(std::string("gaussianElimination, recorded"), explained),
+                                  std::make_pair(std::string("nullity pre-check"), precheck)}) {
+        BenchmarkResult result = runTimed(benchmark.first, bytes, benchmark.second);
+        size_t before = allocationCount.load();
+        benchmark.second();
+        size_t allocations = allocationCount.load() - before;
+        printResult(result);
+        std::cout << "    " << allocations << " allocations per iteration\n";
+    }
+
+    std::cout << "\n";
+}
+
+// Reaction-network shaped system: species/4 elements, each species built
+// from 3-8 of them with small counts, the second half as products
+SparseMatrix<int64_t> makeSparseNetwork(int species, unsigned seed) {
+    std::mt19937 rng(seed);
+    int elements = std::max(species / 4, 8);
+    SparseMatrix<int64_t> matrix(elements, species);
+
+    for (int col = 0; col < species; ++col) {
+        int used = 3 + rng() % 6;
+        for (int k = 0; k < used; ++k) {
+            int64_t count = 1 + rng() % 4;
+            matrix.set(rng() % elements, col, col < species / 2 ? count : -count);
+        }
+    }
+    return matrix;
+}
+
+void benchmarkSparse() {
+    std::cout << "=== Sparse Markowitz vs dense elimination ===\n";
+
+    // Dense forward elimination is cubic, beyond this it takes minutes
+    const int MAX_DENSE_SPECIES = 2000;
+
+    for (int species : {100, 500, 1000, 2000, 5000, 10000}) {
+        SparseMatrix<int64_t> exact = makeSparseNetwork(species, species);
+        SparseMatrix<double> floating(exact.rows(), exact.cols());
+        for (size_t row = 0; row < exact.rows(); ++row) {
+            for (const SparseEntry<int64_t>& entry : exact.row(row)) {
+                floating.row(row).push_back({entry.col, static_cast<double>(entry.value)});
+            }
+        }
+        size_t bytes = exact.nonZeros() * sizeof(SparseEntry<double>);
+        double minSeconds = species >= 5000 ? 0.001 : 0.25;
+        std::string label = std::to_string(species) + " species";
+
+        std::cout << "  " << label << ": " << exact.rows() << " elements, density "
+                  << std::setprecision(4) << exact.density() * 100 << "%\n";
+
+        int denseNullity = -1;
+        if (species <= MAX_DENSE_SPECIES) {
+            DenseMatrix<double> dense = floating.toDense();
+            MatrixSolver solver;
+            printResult(runTimed(label + ", dense rank", bytes, [&]() {
+                denseNullity = solver.nullity(dense);
+            }, minSeconds));
+        }
+
+        SparseEliminator<double> eliminator;
+        size_t nullVectorSize = 0;
+        printResult(runTimed(label + ", sparse + null vector", bytes, [&]() {
+            eliminator.factorize(floating);
+            nullVectorSize = eliminator.nullity() ? eliminator.nullVector(eliminator.freeColumns().back()).size() : 0;
+        }, minSeconds));
+
+        SparseEliminator<int64_t> exactEliminator;
+        bool overflowed = false;
+        printResult(runTimed(label + ", sparse exact", bytes, [&]() {
+            try {
+                exactEliminator.factorize(exact);
+                overflowed = false;
+            } catch (const std::overflow_error&) {
+                overflowed = true;
+            }
+        }, minSeconds));
+
+        std::cout << "    nullity " << eliminator.nullity();
+        if (denseNullity >= 0) std::cout << (static_cast<size_t>(denseNullity) == eliminator.nullity() ? " (dense agrees)" : " (dense DISAGREES)");
+        std::cout << ", non-zeros " << eliminator.initialNonZeros() << " -> peak " << eliminator.peakNonZeros();
+        if (overflowed) std::cout << ", exact overflowed 64 bits";
+        else std::cout << ", exact rank " << exactEliminator.rank();
+        std::cout << "\n";
+        (void)nullVectorSize;
+    }
+
+    std::cout << "\n";
+}
+
+void benchmarkKernels() {
+    std::cout << "=== Row-operation kernels (" << RowKernels::levelName(RowKernels::supportedLevel()) << " supported) ===\n";
+
+    // Each timed iteration runs ROW_OPS operations over a pool of rows, so
+    // short widths are not dominated by the timing loop
+    const size_t ROW_OPS = 64;
+    const size_t POOL_ROWS = 16;
+    // Pivot search walks a column of a matrix this wide, as an element row
+    // of a stoichiometric matrix would be walked down its species
+    const size_t PIVOT_STRIDE = 8;
+
+    std::vector<KernelLevel> levels = {KernelLevel::PORTABLE};
+    if (RowKernels::supportedLevel() != KernelLevel::PORTABLE) levels.push_back(KernelLevel::AVX2);
+    if (RowKernels::supportedLevel() == KernelLevel::AVX512) levels.push_back(KernelLevel::AVX512);
+
+    auto report = [&](const std::string& name, size_t width, KernelLevel level, size_t bytesPerOp,
+                      const std::function<void()>& body) {
+        RowKernels::setLevel(level);
+        BenchmarkResult result = runTimed(name, bytesPerOp * ROW_OPS, body, 0.02);
+        double operations = static_cast<double>(result.iterations) * ROW_OPS;
+        std::cout << "  " << std::left << std::setw(8) << name << std::right << " width " << std::setw(4) << width
+                  << "  " << std::left << std::setw(8) << RowKernels::levelName(level) << std::right
+                  << std::fixed << std::setprecision(2) << std::setw(10) << result.seconds * 1e9 / operations << " ns/op"
+                  << std::setw(10) << result.bytes / result.seconds / 1e9 << " GB/s\n";
+    };
+
+    std::mt19937 rng(18);
+    std::uniform_real_distribution<double> values(-4.0, 4.0);
+    for (size_t width = 8; width <= 4096; width *= 2) {
+        DenseMatrix<double> pool(POOL_ROWS, width);
+        DenseMatrix<double> column(width, PIVOT_STRIDE);
+        for (size_t i = 0; i < POOL_ROWS * width; ++i) pool.data()[i] = values(rng);
+        for (size_t i = 0; i < width * PIVOT_STRIDE; ++i) column.data()[i] = values(rng);
+        size_t sink = 0;
+
+        for (KernelLevel level : levels) {
+            // Scaling by -1 and adding then subtracting the same row keep
+            // the values from drifting towards overflow or denormals
+            report("scale", width, level, 2 * width * sizeof(double), [&]() {
+                for (size_t op = 0; op < ROW_OPS; ++op) {
+                    pool.scaleRow(op % POOL_ROWS, -1.0);
+                }
+            });
+            report("axpy", width, level, 3 * width * sizeof(double), [&]() {
+                for (size_t op = 0; op < ROW_OPS; ++op) {
+                    pool.addScaledRow((op + 1) % POOL_ROWS, op % POOL_ROWS, op % 2 ? -0.5 : 0.5);
+                }
+            });
+            report("pivot", width, level, width * sizeof(double), [&]() {
+                for (size_t op = 0; op < ROW_OPS; ++op) {
+                    sink += column.largestInColumn(op % PIVOT_STRIDE, 0);
+                }
+            });
+        }
+        (void)sink;
+    }
+    RowKernels::setLevel(RowKernels::supportedLevel());
+
+    std::cout << "\n";
+}
+
+void benchmarkModular() {
+    std::cout << "=== Multi-modular exact nullspace ===\n";
+
+    // Dense element-by-species systems with one more species than elements
+    // have a single reaction whose coefficients grow with the size
+    std::mt19937 rng(19);
+    for (int elements : {20, 40, 80, 160}) {
+        DenseMatrix<int64_t> matrix(elements, elements + 1);
+        for (size_t i = 0; i < matrix.rows() * matrix.cols(); ++i) {
+            matrix.data()[i] = rng() % 10;
+        }
+        size_t bytes = matrix.rows() * matrix.cols() * sizeof(int64_t);
+        std::string label = std::to_string(elements) + " elements";
+        double minSeconds = elements >= 160 ? 0.001 : 0.25;
+
+        MatrixSolver solver;
+        solver.setRecordSteps(false);
+        bool overflowed = false;
+        printResult(runTimed(label + ", Bareiss int64", bytes, [&]() {
+            DenseMatrix<int64_t> copy = matrix;
+            try {
+                solver.nullspaceBasis(copy);
+                overflowed = false;
+            } catch (const std::overflow_error&) {
+                overflowed = true;
+            }
+        }, minSeconds));
+
+        DenseMatrix<double> floating(matrix);
+        printResult(runTimed(label + ", Gauss-Jordan double", bytes, [&]() {
+            DenseMatrix<double> copy = floating;
+            solver.nullspaceBasis(copy);
+        }, minSeconds));
+
+        MultiModularSolver modular;
+        std::vector<std::vector<BigInteger>> basis;
+        for (size_t threads : {1, 2, 4}) {
+            modular.setThreadCount(threads);
+            printResult(runTimed(label + ", modular, " + std::to_string(threads) + " thread" + (threads > 1 ? "s" : ""), bytes, [&]() {
+                basis = modular.nullspaceBasis(matrix);
+            }, minSeconds));
+        }
+
+        size_t bits = 0;
+        for (const auto& vector : basis) {
+            for (const BigInteger& value : vector) {
+                bits = std::max(bits, value.bitLength());
+            }
+        }
+        std::cout << "    " << (overflowed ? "Bareiss overflowed" : "Bareiss exact") << ", modular used "
+                  << modular.primesUsed() << " primes, largest coefficient " << bits << " bits\n";
+    }
+
+    std::cout << "\n";
+}
+
+// The division based check CheckedArithmetic.h uses without compiler
+// builtins, so both can be timed on the same machine
+static int64_t portableCheckedMultiply(int64_t a, int64_t b) {
+    uint64_t magnitudeA = a < 0 ? 0 - static_cast<uint64_t>(a) : static_cast<uint64_t>(a);
+    uint64_t magnitudeB = b < 0 ? 0 - static_cast<uint64_t>(b) : static_cast<uint64_t>(b);
+    bool negative = (a < 0) != (b < 0);
+    uint64_t limit = static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + (negative ? 1 : 0);
+    if (magnitudeA != 0 && magnitudeB > limit / magnitudeA) {
+        throwIntegerOverflow();
+    }
+    return a * b;
+}
+
+void benchmarkChecked() {
+    std::cout << "=== Checked coefficient arithmetic ===\n";
+
+    // Atom count times coefficient, summed, as in the balance checks
+    std::mt19937 rng(20);
+    const size_t count = 4096;
+    std::vector<int64_t> atoms(count);
+    std::vector<int64_t> coefficients(count);
+    for (size_t i = 0; i < count; ++i) {
+        atoms[i] = 1 + rng() % 40;
+        coefficients[i] = static_cast<int64_t>(1 + rng() % 1000000) * ((i & 1) ? -1 : 1);
+    }
+    size_t bytes = count * 2 * sizeof(int64_t);
+    volatile int64_t sink = 0;
+
+    printResult(runTimed("multiply-add, unchecked int64", bytes, [&]() {
+        int64_t sum = 0;
+        for (size_t i = 0; i < count; ++i) {
+            sum += atoms[i] * coefficients[i];
+        }
+        sink = sum;
+    }));
+
+    printResult(runTimed("multiply-add, checked int64", bytes, [&]() {
+        int64_t sum = 0;
+        for (size_t i = 0; i < count; ++i) {
+            sum = checkedAdd(sum, checkedMultiply(atoms[i], coefficients[i]));
+        }
+        sink = sum;
+    }));
+
+    printResult(runTimed("multiply-add, portable division check", bytes, [&]() {
+        int64_t sum = 0;
+        for (size_t i = 0; i < count; ++i) {
+            sum = checkedAdd(sum, portableCheckedMultiply(atoms[i], coefficients[i]));
+        }
+        sink = sum;
+    }));
+
+#ifdef CHECKED_ARITHMETIC_INT128
+    printResult(runTimed("multiply-add, int128 with final check", bytes, [&]() {
+        int128 sum = 0;
+        for (size_t i = 0; i < count; ++i) {
+            sum += static_cast<int128>(atoms[i]) * coefficients[i];
+        }
+        if (!fitsInt64(sum)) {
+            throwIntegerOverflow();
+        }
+        sink = static_cast<int64_t>(sum);
+    }));
+#endif
+
+    printResult(runTimed("multiply-add, BigInteger", bytes, [&]() {
+        BigInteger sum;
+        for (size_t i = 0; i < count; ++i) {
+            sum += BigInteger(atoms[i]) * BigInteger(coefficients[i]);
+        }
+        sink = sum.toInt64();
+    }));
+
+    // Floating-point solutions with small denominators, scaled to integers
+    MatrixSolver solver;
+    solver.setRecordSteps(false);
+    for (size_t species : {8, 64, 512}) {
+        std::vector<double> solution(species);
+        for (size_t i = 0; i < species; ++i) {
+            solution[i] = static_cast<double>(1 + rng() % 50) / static_cast<double>(1 + rng() % 12);
+        }
+        std::vector<int64_t> reduced;
+        printResult(runTimed("reduceToIntegers, " + std::to_string(species) + " species",
+                             species * sizeof(double), [&]() {
+            reduced = solver.reduceToIntegers(solution);
+        }));
+    }
+    (void)sink;
+
+    std::cout << "\n";
+}
+
+void benchmarkSmall() {
+    std::cout << "=== Stack-allocated small solver vs generic path ===\n";
+
+    const std::vector<std::string> equations = {
+        "H2 + O2 -> H2O",
+        "Fe + O2 -> Fe2O3",
+        "CH4 + O2 -> CO2 + H2O",
+        "C6H12O6 + O2 -> CO2 + H2O",
+        "Al + HCl -> AlCl3 + H2",
+        "Ca3(PO4)2 + SiO2 + C -> CaSiO3 + P4 + CO",
+        "KMnO4 + HCl -> KCl + MnCl2 + H2O + Cl2",
+        "K2Cr2O7 + H2SO4 + C2H5OH -> Cr2(SO4)3 + K2SO4 + CH3COOH + H2O"
+    };
+    const int CALLS = 20000;
+
+    for (const std::string& text : equations) {
+        ChemicalEquation parsed = EquationBalancer::parseEquationString(text);
+        size_t species = parsed.getReactants().size() + parsed.getProducts().size();
+        std::cout << "  " << text << " (" << species << " species, " << parsed.getAllElementIds().size()
+                  << " elements)\n";
+
+        for (bool small : {false, true}) {
+            EquationBalancer balancer;
+            balancer.setRecordSteps(false);
+            balancer.setSmallSolverEnabled(small);
+
+            // balance() writes the coefficients back, so each call gets a fresh copy
+            std::vector<double> latencies;
+            latencies.reserve(CALLS);
+            size_t allocations = 0;
+            for (int call = 0; call < CALLS; ++call) {
+                ChemicalEquation equation = parsed;
+                size_t before = allocationCount.load(std::memory_order_relaxed);
+                auto start = std::chrono::steady_clock::now();
+                BalanceInfo info = balancer.balance(equation);
+                auto end = std::chrono::steady_clock::now();
+                allocations += allocationCount.load(std::memory_order_relaxed) - before;
+                if (info.result != BalanceResult::SUCCESS) {
+                    throw std::runtime_error("benchmark equation did not balance: " + text);
+                }
+                latencies.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+            }
+            std::sort(latencies.begin(), latencies.end());
+
+            std::cout << "    " << std::left << std::setw(10) << (small ? "small" : "generic") << std::right
+                      << " p50 " << std::fixed << std::setprecision(2) << std::setw(7) << latencies[CALLS / 2]
+                      << " us   p99 " << std::setw(7) << latencies[CALLS * 99 / 100] << " us   "
+                      << std::setprecision(1) << static_cast<double>(allocations) / CALLS << " allocations\n";
+        }
+    }
+
+    std::cout << "\n";
+}
+
+void benchmarkBatch() {
+    std::cout << "=== Batched structure-of-arrays solver ===\n";
+
+    // Random small reactions of the shapes live traffic has
+    const size_t SYSTEMS = 65536;
+    std::vector<DenseMatrix<int64_t>> systems;
+    for (size_t i = 0; i < SYSTEMS; ++i) {
+        systems.push_back(makeStoichiometry(3 + i % 6, 22000 + static_cast<unsigned>(i)));
+    }
+    size_t bytes = 0;
+    for (const auto& system : systems) {
+        bytes += system.rows() * system.cols() * sizeof(int64_t);
+    }
+
+    MatrixSolver solver;
+    solver.setRecordSteps(false);
+    printResult(runTimed("MatrixSolver, one at a time", bytes, [&]() {
+        for (const auto& system : systems) {
+            auto matrix = system;
+            solver.nullspaceBasis(matrix);
+        }
+    }));
+
+    SmallMatrixSolver<8, 8> small;
+    printResult(runTimed("SmallMatrixSolver, one at a time", bytes, [&]() {
+        for (const auto& system : systems) {
+            small.reset(system.rows(), system.cols());
+            for (size_t i = 0; i < system.rows(); ++i) {
+                for (size_t j = 0; j < system.cols(); ++j) {
+                    small.at(i, j) = system[i][j];
+                }
+            }
+            small.solve();
+        }
+    }));
+
+    BatchSolver batch;
+    std::vector<std::vector<int64_t>> vectors;
+    KernelLevel original = RowKernels::getLevel();
+    for (KernelLevel level : {KernelLevel::PORTABLE, KernelLevel::AVX2, KernelLevel::AVX512}) {
+        if (static_cast<int>(level) > static_cast<int>(RowKernels::supportedLevel())) {
+            continue;
+        }
+        RowKernels::setLevel(level);
+        printResult(runTimed(std::string("BatchSolver, ") + RowKernels::levelName(level), bytes, [&]() {
+            vectors = batch.nullVectors(systems);
+        }));
+    }
+    RowKernels::setLevel(original);
+
+    size_t correct = 0;
+    for (size_t i = 0; i < SYSTEMS; ++i) {
+        correct += !vectors[i].empty() && isNullVector(systems[i], vectors[i]);
+    }
+    std::cout << "    " << batch.vectorizedCount() << " systems solved in lanes, " << batch.fallbackCount()
+              << " masked out and solved alone, " << correct << " unique null vectors\n";
+
+    // End to end on parsed equations, results written back to each
+    const std::vector<std::string> catalog = {
+        "H2 + O2 -> H2O",
+        "CH4 + O2 -> CO2 + H2O",
+        "Al + HCl -> AlCl3 + H2",
+        "Ca3(PO4)2 + SiO2 + C -> CaSiO3 + P4 + CO",
+        "KMnO4 + HCl -> KCl + MnCl2 + H2O + Cl2",
+        "K2Cr2O7 + H2SO4 + C2H5OH -> Cr2(SO4)3 + K2SO4 + CH3COOH + H2O"
+    };
+    std::vector<ChemicalEquation> parsed;
+    for (size_t i = 0; i < 8192; ++i) {
+        parsed.push_back(EquationBalancer::parseEquationString(catalog[i % catalog.size()]));
+    }
+
+    EquationBalancer balancer;
+    balancer.setRecordSteps(false);
+    std::vector<ChemicalEquation> equations;
+    printResult(runTimed("balance() per equation, 8192 equations", 0, [&]() {
+        equations = parsed;
+        for (auto& equation : equations) {
+            balancer.balance(equation);
+        }
+    }));
+    printResult(runTimed("balanceBatch(), 8192 equations", 0, [&]() {
+        equations = parsed;
+        balancer.balanceBatch(equations);
+    }));
+
+    std::cout << "\n";
+}
+
+void benchmarkLattice() {
+    std::cout << "=== Smallest positive combination (HNF, LLL, branch and bound) ===\n";
+
+    // Reactions with a few elements and many species; only systems that
+    // have a strictly positive solution are kept
+    std::mt19937 rng(23);
+    const size_t SAMPLES = 40;
+    for (size_t nullity : {2, 4, 6, 8, 10}) {
+        std::vector<DenseMatrix<int64_t>> systems;
+        LatticeSolver probe;
+        while (systems.size() < SAMPLES) {
+            size_t elements = 3 + rng() % 3;
+            size_t species = elements + nullity;
+            DenseMatrix<int64_t> matrix(elements, species, 0);
+            for (size_t col = 0; col < species; ++col) {
+                for (int k = 0; k < 2; ++k) {
+                    int64_t count = 1 + rng() % 6;
+                    matrix[rng() % elements][col] = col < species / 2 ? count : -count;
+                }
+            }
+            if (probe.minimalPositive(matrix).size() == species && probe.isProvenMinimal()) {
+                systems.push_back(matrix);
+            }
+        }
+
+        for (size_t budget : {size_t(100), size_t(1000), LatticeSolver::DEFAULT_SEARCH_BUDGET}) {
+            LatticeSolver solver;
+            solver.setSearchBudget(budget);
+            std::vector<double> latencies;
+            size_t proven = 0;
+            size_t maxNodes = 0;
+            for (const auto& matrix : systems) {
+                auto start = std::chrono::steady_clock::now();
+                solver.minimalPositive(matrix);
+                latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+                proven += solver.isProvenMinimal();
+                maxNodes = std::max(maxNodes, solver.nodesVisited());
+            }
+            std::sort(latencies.begin(), latencies.end());
+
+            std::cout << "  nullity " << std::setw(2) << nullity << ", budget " << std::setw(5) << budget
+                      << "  p50 " << std::fixed << std::setprecision(1) << std::setw(8) << latencies[SAMPLES / 2]
+                      << " us  max " << std::setw(8) << latencies.back() << " us  most nodes " << std::setw(5) << maxNodes
+                      << "  proven minimal " << proven << "/" << SAMPLES << "\n";
+        }
+    }
+
+    std::cout << "\n";
+}
+
+void benchmarkBlocked() {
+    std::cout << "=== Blocked dense elimination (" << std::thread::hardware_concurrency() << " hardware threads) ===\n";
+
+    // Dense systems far past the sparse engine's range, as whole-mechanism
+    // models with thousands of species produce after lumping
+    std::mt19937 rng(24);
+    for (size_t rows : {500, 1000, 2000}) {
+        size_t cols = rows * 5 / 2;
+        DenseMatrix<double> system(rows, cols);
+        for (size_t i = 0; i < rows * cols; ++i) system.data()[i] = static_cast<double>(static_cast<int>(rng() % 9) - 4);
+
+        double flops = 0.0;
+        for (size_t pivot = 0; pivot < rows; ++pivot) flops += 2.0 * (rows - pivot - 1) * (cols - pivot);
+
+        auto solve = [&](size_t blockSize, size_t threads, std::vector<double>& solution) {
+            MatrixSolver solver;
+            solver.setRecordSteps(false);
+            solver.setSparseDensityThreshold(0.0);
+            solver.setBlockSize(blockSize);
+            solver.setThreadCount(threads);
+            DenseMatrix<double> matrix = system;
+            auto start = std::chrono::steady_clock::now();
+            solution = solver.gaussianElimination(matrix);
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        };
+        auto report = [&](const std::string& name, double seconds, double baseline, bool identical) {
+            std::cout << "  " << rows << "x" << cols << "  " << std::left << std::setw(20) << name << std::right
+                      << std::fixed << std::setprecision(3) << std::setw(9) << seconds << " s"
+                      << std::setprecision(2) << std::setw(8) << flops / seconds / 1e9 << " GFLOP/s"
+                      << std::setw(7) << baseline / seconds << "x" << (identical ? "  identical\n" : "  DIFFERS\n");
+        };
+
+        std::vector<double> reference;
+        double unblocked = solve(0, 1, reference);
+        report("row at a time", unblocked, unblocked, true);
+        for (size_t threads = 1; threads <= 64; threads *= 2) {
+            std::vector<double> solution;
+            double seconds = solve(MatrixSolver::DEFAULT_BLOCK_SIZE, threads, solution);
+            bool identical = solution.size() == reference.size() &&
+                             std::equal(solution.begin(), solution.end(), reference.begin(),
+                                        [](double a, double b) { return std::memcmp(&a, &b, sizeof(double)) == 0; });
+            report("blocked, threads " + std::to_string(threads), seconds, unblocked, identical);
+        }
+
+        // nullspaceBasis, which balance() runs in floating point: the
+        // blocked form clears above the pivots afterwards, so compare values
+        auto basis = [&](size_t blockSize, size_t threads, std::vector<std::vector<double>>& vectors) {
+            MatrixSolver solver;
+            solver.setRecordSteps(false);
+            solver.setSparseDensityThreshold(0.0);
+            solver.setBlockSize(blockSize);
+            solver.setThreadCount(threads);
+            DenseMatrix<double> matrix = system;
+            auto start = std::chrono::steady_clock::now();
+            vectors = solver.nullspaceBasis(matrix);
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        };
+        std::vector<std::vector<double>> referenceBasis;
+        double gaussJordan = basis(0, 1, referenceBasis);
+        std::cout << "  " << rows << "x" << cols << "  " << std::left << std::setw(20) << "nullspace unblocked" << std::right
+                  << std::fixed << std::setprecision(3) << std::setw(9) << gaussJordan << " s\n";
+        for (size_t threads : {1, 4}) {
+            std::vector<std::vector<double>> vectors;
+            double seconds = basis(MatrixSolver::DEFAULT_BLOCK_SIZE, threads, vectors);
+            double difference = vectors.size() == referenceBasis.size() ? 0.0 : INFINITY;
+            for (size_t i = 0; i < vectors.size() && i < referenceBasis.size(); ++i) {
+                for (size_t j = 0; j < cols; ++j) {
+                    difference = std::max(difference, std::abs(vectors[i][j] - referenceBasis[i][j]));
+                }
+            }
+            std::cout << "  " << rows << "x" << cols << "  " << std::left << std::setw(20)
+                      << "nullspace, threads " + std::to_string(threads) << std::right << std::setprecision(3)
+                      << std::setw(9) << seconds << " s" << std::setprecision(2) << std::setw(8) << gaussJordan / seconds
+                      << "x  max difference " << std::scientific << difference << std::fixed << "\n";
+        }
+    }
+
+    std::cout << "\n";
+}
+
+void benchmarkMixed() {
+    std::cout << "=== Mixed precision with exact verification ===\n";
+
+    const int SAMPLES = 32;
+    for (int species : {5, 10, 20, 50, 100}) {
+        std::vector<DenseMatrix<int64_t>> systems;
+        for (int sample = 0; sample < SAMPLES; ++sample) {
+            systems.push_back(makeStoichiometry(species, 2500 * species + sample));
+        }
+        size_t bytes = SAMPLES * (species - 1) * species * sizeof(int64_t);
+
+        MatrixSolver solver;
+        solver.setRecordSteps(false);
+        std::vector<std::vector<std::vector<int64_t>>> exact(SAMPLES);
+        printResult(runTimed(std::to_string(species) + " species, exact", bytes, [&]() {
+            for (int i = 0; i < SAMPLES; ++i) {
+                DenseMatrix<int64_t> matrix = systems[i];
+                try {
+                    exact[i] = solver.nullspaceBasis(matrix);
+                } catch (const std::overflow_error&) {
+                    exact[i].clear();
+                }
+            }
+        }));
+
+        // What MIXED_PRECISION mode runs: the exact solver only for the
+        // systems whose floating-point answer does not verify
+        MixedPrecisionSolver mixed;
+        std::vector<std::vector<int64_t>> basis;
+        int single = 0, twice = 0, escalated = 0, mismatches = 0;
+        printResult(runTimed(std::to_string(species) + " species, mixed + escalation", bytes, [&]() {
+            single = twice = escalated = mismatches = 0;
+            for (int i = 0; i < SAMPLES; ++i) {
+                if (!mixed.nullspaceBasis(systems[i], basis)) {
+                    ++escalated;
+                    DenseMatrix<int64_t> matrix = systems[i];
+                    try {
+                        basis = solver.nullspaceBasis(matrix);
+                    } catch (const std::overflow_error&) {
+                        basis.clear();
+                    }
+                } else {
+                    (mixed.precision() == FloatPrecision::SINGLE ? single : twice)++;
+                }
+                mismatches += basis != exact[i];
+            }
+        }));
+
+        int wrong = 0;
+        printResult(runTimed(std::to_string(species) + " species, floating point", bytes, [&]() {
+            wrong = 0;
+            for (int i = 0; i < SAMPLES; ++i) {
+                DenseMatrix<double> matrix(systems[i]);
+                basis.clear();
+                try {
+                    for (const auto& solution : solver.nullspaceBasis(matrix)) {
+                        basis.push_back(solver.reduceToIntegers(solution));
+                    }
+                } catch (const std::overflow_error&) {
+                    basis.clear();
+                }
+                wrong += basis != exact[i];
+            }
+        }));
+
+        std::cout << "    verified in float " << single << ", in double " << twice << ", escalated " << escalated
+                  << ", differing from exact " << mismatches << "; unverified floating point wrong " << wrong
+                  << "/" << SAMPLES << "\n";
+    }
+
+    std::cout << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    // Initialize database outside of the timed regions
+    CompoundDatabase::getInstance();
+
+    std::string arg = argc > 1 ? argv[1] : "all";
+
+    if (arg == "help" || arg == "--help" || arg == "-h") {
+        printUsage(argv[0]);
+        return 0;
+    }
+
+    bool all = arg == "all";
+    bool matched = false;
+
+    if (all || arg == "parse") {
+        benchmarkParsing();
+        matched = true;
+    }
+
+    if (all || arg == "cache") {
+        benchmarkFormulaCache();
+        matched = true;
+    }
+
+    if (all || arg == "validate") {
+        benchmarkValidation();
+        matched = true;
+    }
+
+    if (all || arg == "incremental") {
+        benchmarkIncremental();
+        matched = true;
+    }
+
+    if (all || arg == "solver") {
+        benchmarkSolver();
+        matched = true;
+    }
+
+    if (all || arg == "matrix") {
+        benchmarkMatrix();
+        matched = true;
+    }
+
+    if (all || arg == "steps") {
+        benchmarkSteps();
+        matched = true;
+    }
+
+    if (all || arg == "rank") {
+        benchmarkRank();
+        matched = true;
+    }
+
+    if (all || arg == "sparse") {
+        benchmarkSparse();
+        matched = true;
+    }
+
+    if (all || arg == "kernels") {
+        benchmarkKernels();
+        matched = true;
+    }
+
+    if (all || arg == "modular") {
+        benchmarkModular();
+        matched = true;
+    }
+
+    if (all || arg == "checked") {
+        benchmarkChecked();
+        matched = true;
+    }
+
+    if (all || arg == "small") {
+        benchmarkSmall();
+        matched = true;
+    }
+
+    if (all || arg == "batch") {
+        benchmarkBatch();
+        matched = true;
+    }
+
+    if (all || arg == "lattice") {
+        benchmarkLattice();
+        matched = true;
+    }
+
+    if (all || arg == "blocked") {
+        benchmarkBlocked();
+        matched = true;
+    }
+
+    if (all || arg == "mixed") {
+        benchmarkMixed();
+        matched = true;
+    }
+
+    if (!matched) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    return 0;
+}